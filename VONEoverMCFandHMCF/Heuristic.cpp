@@ -7,16 +7,60 @@
 //------------------------------------------------
 
 #include "Heuristic.h"
+#include "Result.h"
+#include "Profiler.h"
 
 #include <algorithm>
 #include <numeric>
 #include <cstdlib>
+#include <climits>
 #include <iterator>
 #include <cmath>
 #include <fstream>
+#include <map>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace
 {
+	//How the crosstalk between adjacent cores is treated, which is parsed once from the string CrosstalkYesorNo:
+	enum Crosstalk_Policy
+	{
+		Crosstalk_Allowed,		//"Yes" or "yes", the cores are used in the natural order without classification
+		Crosstalk_Avoided,		//"No" or "no", the cores are prioritized and classified by service type
+		Crosstalk_Unspecified	//Any other string, the cores are prioritized but not classified
+	};
+
+	//The container of per-core values, a fixed size array on the stack when the number of cores is known at compile time, 
+	//    so that the loops over the cores are bounded by a constant, and a vector when Core_Num is 0
+	template <int Core_Num>
+	struct Core_Set
+	{
+		typedef array<int, Core_Num> type;
+		static type make(const int) { type set = {}; return set; }
+	};
+
+	template <>
+	struct Core_Set<0>
+	{
+		typedef vector<int> type;
+		static type make(const int CoreNumber) { return type(CoreNumber); }
+	};
+
+	Crosstalk_Policy Parse_Crosstalk(const string& CrosstalkYesorNo);
+	//Postcondition: Return the crosstalk policy given by CrosstalkYesorNo
+
+	void Core_Table_Define(VONEHeuristic::Core_Table& Table, const vector<int>& Core_Priority, vector<int>& Core_Classification, const int Hetergeneous_Core);
+	//Precondition: Core_Priority_Define and Core_Classification_Define have been excuted
+	//Postcondition: The hetergeneous core has been classified as 2 and the unclassified cores as -1 if there is a hetergeneous core,
+	//    and the cores allowed for each service type have been stored into Table
+
 	bool VNcompare(const VONETopo::Topo& VNA, const VONETopo::Topo& VNB);
 	//Precondition: The Topo VNA and VNB has been initialized
 	//Postcondition: Return the comparison results between VNA and VNB according to vertex number first and then edge number
@@ -29,179 +73,648 @@ namespace
 	//Precondition: The Vertex UVA and UVB has been initialized
 	//Postcondition: Return the comparison results between UVA and UVB according to remaining computing resource
 
+	void Order_Virtual_Networks(const vector<VONETopo::Topo>& Virtual_Network_List, const int Start, const unsigned int Seed, vector<int>& Order);
+	//Postcondition: Order holds the indexes of Virtual_Network_List in the ordering of the start Start of the multi-start heuristic, 
+	//    which is the same as the sort by VNcompare for the start 0, and otherwise is drawn from Seed and Start
+
+	int Max_Slot_Index(const VONESpectrum::Spectrum_Arena& SN_Spectrum);
+	//Postcondition: Return the Maximum Frequency Slot Index over all links, cores and directions of SN_Spectrum
+
+	//The substrate state shared by the threads of the concurrent embedding, which only holds what decides whether 
+	//    an allocation fits: the occupancy words indexed as [link][core index][word] and the remaining computing resource 
+	//    of each substrate node. The committed allocations are appended to _commit_log, and each is published by setting 
+	//    its _commit_owner to the thread which has committed it after it has been written, -1 until then. _commit_num is moved on 
+	//    only by the thread whose replica holds all the allocations before it, and a blocked virtual network is logged with _vertex_num 0
+	struct Shared_Substrate
+	{
+		int _word_num;
+		int _core_num;
+		vector<atomic<VONESpectrum::Spectrum_Word> > _word;
+		vector<atomic<int> > _computing;
+		vector<VONEHeuristic::Allocation> _commit_log;
+		vector<int> _commit_request;		//The virtual network of each committed allocation
+		vector<atomic<int> > _commit_owner;
+		atomic<int> _commit_num;
+
+		Shared_Substrate(const VONETopo::Topo& Substrate_Network, const VONESpectrum::Spectrum_Arena& SN_Spectrum, const int Request_Num);
+		//Postcondition: All frequency slots and computing resources are free, and the log has room for Request_Num allocations
+	};
+
+	VONESpectrum::Spectrum_Word Slot_Word_Mask(const int Word, const int Start, const int Width);
+	//Precondition: The frequency slots from Start to Start + Width - 1 overlap the word Word
+	//Postcondition: Return the bits of the frequency slots in the word
+
+	bool Reserve_Allocation(Shared_Substrate& Shared, const VONEHeuristic::Allocation& Record);
+	//Postcondition: The computing resource has been taken by atomic subtraction and the frequency slots by compare and swap 
+	//    on each occupancy word, and return true when all of them were free. Otherwise everything taken has been returned, and return false
+
+	void Return_Allocation(Shared_Substrate& Shared, const VONEHeuristic::Allocation& Record);
+	//Precondition: Record has been reserved by Reserve_Allocation
+	//Postcondition: The frequency slots and the computing resource of Record have been returned
+
 	int Request_Type(const int Bandwidth);
 	//Precondition: Bandwidth has been assignment
 	//Postcondition: Return the request type of that the edge_width equals Bandwidth
 
-	int Core_Distance(const int Core1_index, const int Core2_index, const int C);
-	//Precondition: Core1_index and Core2_index have been assigned
-	//Postcondition: Return the distance of two core index, which is an auxiliary function for function Nearest_Core_with_Same_Cost
-
-	int Nearest_Core_with_Same_Cost(const vector<int>& Core_Cost, const vector<int>::iterator& Initial_index, const int Last_Priority_Core, const int CoreNumber);
+	int Nearest_Core_with_Same_Cost(const vector<int>& Core_Cost, const vector<int>::iterator& Initial_index, const int Last_Priority_Core, 
+		const VONELayout::Core_Layout& Layout);
 	//Precondition: Core_Cost, Initial_index and Last_Priority_Core have been assigned
 	//Postcondition: Return the nearest core of Last_Priority_Core in the same cost core, which is an auxiliary function for function Core_Priority_Define
 
-	void Core_Priority_Define(vector<int>& Core_Priority, const int Hetergeneous_Core, const int CoreNumber, ofstream& outs);
-	//Precondition: Core_Priority has been assignment, Hetergeneous indicates the index of the hetergeneous core, outs has been connected to a file stream
-	//Postcondition: Core Priority of all cores has been defined into Core_Priority, and log file has been recorded
+	void Core_Priority_Define(vector<int>& Core_Priority, const int Hetergeneous_Core, const VONELayout::Core_Layout& Layout, VONELog::Logger& Log);
+	//Precondition: Core_Priority has been assignment, Hetergeneous indicates the index of the hetergeneous core, Log has been given
+	//Postcondition: Core Priority of all cores has been defined into Core_Priority, and the records have been written into Log
 
-	void Core_Classification_Define(vector<int>& Core_Classification, const vector<int> Core_Priority, const vector<int> Service_Type, const int CoreNumber, ofstream& outs);
+	void Core_Classification_Define(vector<int>& Core_Classification, const vector<int>& Core_Priority, const vector<int>& Service_Type, 
+		const VONELayout::Core_Layout& Layout, VONELog::Logger& Log);
 	//Precondition: Core_Priority_Define has been excuted, and Core_Classification has been assignment, Service_Type has been listed, 
-	//    and outs has been connected to a file stream
-	//Postcondition: Core Classification has been defined into Core_Classification, and log file has been recorded
+	//    and Log has been given
+	//Postcondition: Core Classification has been defined into Core_Classification, and the records have been written into Log
 
 	void Vertexes_Embedding(VONETopo::NodeList& Virtual_Network_NodeList, vector<VONEHeuristic::Utilited_Vertex>& SN_Utilited_Vertex,
-		vector<int>& vertex_embedding_result, ofstream& outs);
-	//Precondition: Virtual_Network_NodeList, SN_Utilited_Vertex and vertex_embedding_result has been assignment, and outs has been connected to a file stream
-	//Postcondition: The result of vertexes embedding has been put into vertex_embedding_result, and log file has been recorded
-
-	void get_SN_EdgeList(VONETopo::LinkList& SN_Edge, const vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge);
-	//Precondition: SN_Edge, SN_Utilited_Edge has been assignment
-	//Postcondition: _edge in SN_Utilited_Edge has been put into SN_Edge, which is an auxiliary function for function Edges_Embedding, Core_Assignment and Frequency_Allocating
-
-	void Edges_Embedding(const VONETopo::LinkList& Virtual_Network_EdgeList, const int Number_of_SN_Vertex,
-		const vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, const vector<int>& vertex_embedding_result, vector<vector<int> >& edge_embedding_result, ofstream& outs);
-	//Precondition: Virtual_Network_NodeList, Number_of_SN_Vertex, SN_Utilited_Edge, vertex_embedding_result and edge_embedding_result has been assignment, 
-	//    and outs has been connected to a file stream
-	//Postcondition: The result of edges embedding has been put into edge_embedding_result, and log file has been recorded
-
-	void Frequency_Recovery(const vector<vector<int> >& edge_embedding_result, vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, const int CoreNumber);
-	//Precondition: edge_embedding_result and SN_Utilited_Edge have been assignment
-	//Postcondition: Clear the pre-allocating frequency slots in SN_Utilited_Edge
+		vector<int>& vertex_embedding_result, const bool Return_on_Block, VONELog::Logger& Log);
+	//Precondition: Virtual_Network_NodeList, SN_Utilited_Vertex and vertex_embedding_result has been assignment, and Log has been given
+	//Postcondition: The result of vertexes embedding has been put into vertex_embedding_result, and the records have been written into Log. 
+	//    The computing resource taken before a block is returned only when Return_on_Block is true
+
+	void Edges_Embedding(const VONETopo::LinkList& Virtual_Network_EdgeList, VONETopo::Graph& SN_Resource,
+		const VONESpectrum::Spectrum_Arena& SN_Spectrum, const vector<int>& vertex_embedding_result, vector<vector<int> >& edge_embedding_result, VONELog::Logger& Log);
+	//Precondition: Virtual_Network_NodeList, SN_Spectrum, vertex_embedding_result and edge_embedding_result has been assignment, SN_Resource has been 
+	//    built from the edges of the substrate network in the order of the links in SN_Spectrum, and Log has been given
+	//Postcondition: The result of edges embedding has been put into edge_embedding_result, and the records have been written into Log
+
+	bool Candidate_Edges_Embedding(const VONETopo::LinkList& Virtual_Network_EdgeList, const VONETopo::Topo& Substrate_Network, 
+		const vector<vector<vector<int> > >& Path_Candidate, const int Vertex_Num, const int Rank, const VONESpectrum::Spectrum_Arena& SN_Spectrum, 
+		const vector<int>& vertex_embedding_result, vector<vector<int> >& edge_embedding_result, VONELog::Logger& Log);
+	//Precondition: Path_Candidate holds the candidate paths of each pair of the Vertex_Num substrate nodes, Rank >= 0, 
+	//    and the others are the same as the function Edges_Embedding
+	//Postcondition: Each link of the VN has been embedded on the candidate path of Rank, or on its last candidate path when it has fewer, 
+	//    with the cost of the Path Distances in SN_Spectrum, and the records have been written into Log. 
+	//    Return whether any link has a candidate path of Rank
 
 	int Core_Index(const int node1_id, const int node2_id, const int current_core);
 	//Precondition: node1_id, node2_id and current_core have been assignment
 	//Postcondition: Return the core index of source node1_id to destination node2_id
 
-	void Core_Assignment(const vector<vector<int> >& edge_embedding_result, const vector<int> Core_Priority, const int Hetergeneous_Core,
-		vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, vector<int>& Core_Classification, int VN_Bandwidth,
-		vector<int>& core_assignment_result, int& start_frequency, const int CoreNumber, ofstream& outs);
-	//Precondition: edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Utilited_Edge, Core_Classification, VN_Bandwidth, core_assignment_result 
-	//    and start_frequency have been assignment, and outs has been connnected to a file stream
+	void Core_Assignment(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& Core_Priority, 
+		const int Hetergeneous_Core, VONESpectrum::Spectrum_Arena& SN_Spectrum, const vector<int>& Core_Classification, const VONEHeuristic::Core_Table& Table, 
+		int VN_Bandwidth, vector<int>& core_assignment_result, int& start_frequency, const int CoreNumber, VONEHeuristic::Core_Scratch& Scratch, VONELog::Logger& Log);
+	//Precondition: Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table, VN_Bandwidth, 
+	//    core_assignment_result and start_frequency have been assignment, and Log has been given
 	//Postcondition: The result of core assignment and start frequency have been stored into core_assignment_result and start_frequency, 
-	//    and log file has been recorded
-
-	void Frequency_Allocating(const vector<vector<int> >& edge_embedding_result, const vector<int> core_assignment_result, const int start_frequency,
-		const int Hetergeneous_Core, vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, int VN_Bandwidth);
-	//Precondition: edge_embedding_result, core_assignment_result, start_frequency, Hetergeneous_Core, SN_Utilited_Edge, and VN_Bandwidth have been assignment
-	//Postcondition: The result of frequency allocating has been stored into SN_Utilited_Edge
+	//    and the records have been written into Log. The buffers of Scratch have been used and left as they are for the next call. 
+	//    The instance of Fixed_Core_Assignment for CoreNumber is called when there is one. 
+	//    The slots tried for a start frequency slot given up are always freed again. The original implementation marked them -1 
+	//    and did not always clear the marks, as for a start given up on the first link or a slot marked in both directions, 
+	//    so those slots stayed taken for the later virtual networks, and its results differ from these whenever that happened
+
+	template <int Core_Num>
+	void Fixed_Core_Assignment(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& Core_Priority, 
+		const int Hetergeneous_Core, VONESpectrum::Spectrum_Arena& SN_Spectrum, const vector<int>& Core_Classification, const VONEHeuristic::Core_Table& Table, 
+		int VN_Bandwidth, vector<int>& core_assignment_result, int& start_frequency, const int CoreNumber, VONEHeuristic::Core_Scratch& Scratch, VONELog::Logger& Log);
+	//Precondition: The same as the function Core_Assignment, and Core_Num is CoreNumber or 0
+	//Postcondition: The same as the function Core_Assignment. When Core_Num is not 0, the allowed cores and the start of each core 
+	//    are kept in arrays of Core_Num on the stack, and nothing is allocated once Scratch has grown
+
+	void Frequency_Allocating(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& core_assignment_result, 
+		const int start_frequency, const int Hetergeneous_Core, const VONELayout::Core_Layout& Layout, VONESpectrum::Spectrum_Arena& SN_Spectrum, int VN_Bandwidth, 
+		VONESpectrum::Spectrum_Transaction* Undo = NULL);
+	//Precondition: Substrate_Network, edge_embedding_result, core_assignment_result, start_frequency, Hetergeneous_Core, Layout, SN_Spectrum, and VN_Bandwidth have been assignment
+	//Postcondition: The result of frequency allocating has been stored into SN_Spectrum, and the End Frequency Slots and the Path Distances 
+	//    changed by it have been recorded into Undo when it is not NULL
+
+	bool Same_Paths(const vector<vector<int> >& edge_embedding_result, const vector<vector<int> >& Other_Result);
+	//Postcondition: Return whether the two results of edges embedding take the same substrate paths, whatever their distances
+
+	bool Core_Assignment_Free(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& core_assignment_result, 
+		const int start_frequency, const int Width, const VONESpectrum::Spectrum_Arena& SN_Spectrum);
+	//Precondition: core_assignment_result holds a core index for each hop of edge_embedding_result
+	//Postcondition: Return whether the Width frequency slots from start_frequency are free on the core of each hop in SN_Spectrum
+
+	void Update_End_Slot(VONESpectrum::Spectrum_Arena& SN_Spectrum, const int Link, const int Core_Index, VONESpectrum::Spectrum_Transaction* Undo = NULL);
+	//Precondition: The frequency slots of Core_Index in Link have just been allocated or returned
+	//Postcondition: The End Frequency Slot of the core has been set to the highest used slot of Core_Index, or 1 when it is empty, 
+	//    and the Path Distance of Link to the largest End Frequency Slot of its cores. Every change of the spectrum goes through it, 
+	//    so that the End Frequency Slots only depend on the order of the allocations and the releases. 
+	//    Their old values have been recorded into Undo when it is not NULL, since the rule does not give them back on a release
+
+	//The virtual networks speculated at once by each thread of the parallel solve
+	const int Wave_Factor = 4;
+
+	//The logger of the online engine when none is given, which writes nothing
+	VONELog::Logger Silent_Log;
 }
 
 namespace VONEHeuristic
 {
-	VONEHeuristic::VONEHeuristic() : _block_num(0)
+	VONEHeuristic::VONEHeuristic() : _hetergeneous_core(0), _path_candidate_num(0), _log_level(VONELog::Log_Trace), _logger(NULL), 
+		_result_sink(NULL), _spectrum_dump(false), _request_num(0), _undo(NULL), _block_num(0)
 	{
 
 	}
 
+	VONEHeuristic::VONEHeuristic(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout, 
+		int HeterogeneousCoreIndex, string CrosstalkYesorNo) : _hetergeneous_core(0), _path_candidate_num(0), _log_level(VONELog::Log_Trace), _logger(NULL), 
+		_result_sink(NULL), _spectrum_dump(false), _request_num(0), _undo(NULL), _block_num(0)
+	{
+		prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo);
+	}
+
 	void VONEHeuristic::solve(const VONETopo::Topo& Substrate_Network,
 		vector<VONETopo::Topo>& Virtual_Network_List, int CoreNumber, 
 		int HeterogeneousCoreIndex, string CrosstalkYesorNo)
 	{
-		ofstream fout;
-		fout.open("log.dat"); //Use log file to record some information
-		if (fout.fail())
+		solve(Substrate_Network, Virtual_Network_List, VONELayout::Core_Layout(CoreNumber), HeterogeneousCoreIndex, CrosstalkYesorNo);
+	}
+
+	void VONEHeuristic::solve(const VONETopo::Topo& Substrate_Network,
+		vector<VONETopo::Topo>& Virtual_Network_List, const VONELayout::Core_Layout& Layout, 
+		int HeterogeneousCoreIndex, string CrosstalkYesorNo)
+	{
+		VONELog::Logger Log("log.dat", _log_level); //Use log file to record some information
+
+		//Sort the virtual networks according to the vertex size and edge size:
+		sort(Virtual_Network_List.begin(), Virtual_Network_List.end(), VNcompare);
+
+		solve_ordered(Substrate_Network, Virtual_Network_List, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Log);
+	}
+
+	void VONEHeuristic::solve_multistart(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List, 
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, 
+		const int Start_Num, const int Thread_Num, const unsigned int Seed)
+	{
+		if (Start_Num < 1 || Thread_Num < 0)
 		{
-			cerr << "File log.dat opening failed.\n";
+			cerr << "Number of starts should be positive and number of threads should not be negative!\n";
 			exit(1);
 		}
 
-		//Initialize the utilited vertex of the substrate network:
-		vector<Utilited_Vertex> SN_Utilited_Vertex;
-		VONETopo::NodeList SN_Vertex;
-		Substrate_Network.get_vertex(SN_Vertex);
-		for (VONETopo::NodeListIT iter = SN_Vertex.begin(); iter != SN_Vertex.end(); iter++)
+		//Each start solves its own ordering on its own heuristic, and the starts are handed out to the threads one by one. 
+		//    The candidate paths are built here once and shared by all of them:
+		build_path_candidate(Substrate_Network);
+		vector<vector<int> > Order(Start_Num);
+		vector<pair<int, int> > Score(Start_Num);
+		atomic<int> Next_Start(0);
+		auto Worker = [&]()
 		{
-			Utilited_Vertex tmp;
-			tmp._vertex = *iter;
-			tmp._remaining_computing_resource = iter->_vertex_computing_capacity;
-			SN_Utilited_Vertex.push_back(tmp);
+			for (int start = Next_Start++; start < Start_Num; start = Next_Start++)
+			{
+				Order_Virtual_Networks(Virtual_Network_List, start, Seed, Order[start]);
+				vector<VONETopo::Topo> Ordered_List;
+				Ordered_List.reserve(Order[start].size());
+				for (vector<int>::const_iterator iter = Order[start].begin(); iter != Order[start].end(); iter++)
+					Ordered_List.push_back(Virtual_Network_List[*iter]);
+
+				VONEHeuristic Instance;
+				share_path_candidate(Instance);
+				Instance.solve_ordered(Substrate_Network, Ordered_List, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Silent_Log);
+				Score[start] = make_pair(Instance._block_num, Max_Slot_Index(Instance._spectrum));
+			}
+		};
+
+		int Worker_Num = Thread_Num > 0 ? Thread_Num : max(1, static_cast<int>(thread::hardware_concurrency()));
+		Worker_Num = min(Worker_Num, Start_Num);
+		vector<thread> Pool;
+		for (int i = 1; i < Worker_Num; i++)
+			Pool.push_back(thread(Worker));
+		Worker();
+		for (vector<thread>::iterator iter = Pool.begin(); iter != Pool.end(); iter++)
+			iter->join();
+
+		//The fewest blocks win, then the lowest Maximum Frequency Slot Index, then the earliest start so that the threads do not matter:
+		int Best = static_cast<int>(min_element(Score.begin(), Score.end()) - Score.begin());
+		vector<VONETopo::Topo> Best_List;
+		Best_List.reserve(Virtual_Network_List.size());
+		for (vector<int>::const_iterator iter = Order[Best].begin(); iter != Order[Best].end(); iter++)
+			Best_List.push_back(Virtual_Network_List[*iter]);
+		Virtual_Network_List.swap(Best_List);
+
+		//The best ordering is solved once more here, which gives the same solution and records it into the log and the result sink:
+		VONELog::Logger Log("log.dat", _log_level);
+		solve_ordered(Substrate_Network, Virtual_Network_List, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Log);
+	}
+
+	void VONEHeuristic::solve_anytime(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List, 
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, 
+		const double Time_Budget, const unsigned int Seed)
+	{
+		if (Time_Budget < 0)
+		{
+			cerr << "Time budget of the simulated annealing should not be negative!\n";
+			exit(1);
 		}
+		chrono::steady_clock::time_point Start_Time = chrono::steady_clock::now();
+		VONELog::Logger Log("log.dat", _log_level);
+		sort(Virtual_Network_List.begin(), Virtual_Network_List.end(), VNcompare);
+		prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Log);
 
-		//Initialize the utilited edge of the substrate network:
-		vector<Utilited_Edge> SN_Utilited_Edge;
-		VONETopo::LinkList SN_Edge;
-		Substrate_Network.get_edge(SN_Edge);
-		for (VONETopo::LinkList::iterator iter = SN_Edge.begin(); iter != SN_Edge.end(); iter++)
+		//The records are written once for the solution kept, not for each move:
+		VONEResult::Result_Sink* Sink = _result_sink;
+		_result_sink = NULL;
+
+		//The greedy solution:
+		int VN_Num = static_cast<int>(Virtual_Network_List.size());
+		vector<Embedding_Result> Current(VN_Num);
+		vector<int> Blocked;
+		for (int i = 0; i < VN_Num; i++)
+		{
+			Current[i] = embed(Virtual_Network_List[i]);
+			if (Current[i]._handle == -1)
+				Blocked.push_back(i);
+		}
+		int Greedy_Block = static_cast<int>(Blocked.size()), Greedy_Max_Slot = Max_Slot_Index(_spectrum);
+
+		//The best solution is kept as the records and the allocations of the virtual networks, the blocked ones with no vertex, 
+		//    together with a copy of the substrate state, so that it is given back exactly as it was found:
+		Allocation Empty_Allocation = { 0, 0, 0, 0, 0, vector<int>() };
+		vector<Embedding_Result> Best;
+		vector<Allocation> Best_Allocation(VN_Num, Empty_Allocation);
+		VONESpectrum::Spectrum_Arena Best_Spectrum(_spectrum);
+		vector<Utilited_Vertex> Best_Vertex;
+		vector<int> Best_Position;
+		auto Save_Best = [&]()
+		{
+			Best = Current;
+			for (int i = 0; i < VN_Num; i++)
+				Best_Allocation[i] = (Current[i]._handle == -1) ? Empty_Allocation : _allocation[Current[i]._handle];
+			Best_Spectrum = _spectrum;
+			Best_Vertex = _sn_vertex;
+			Best_Position = _sn_position;
+		};
+		long long Current_Energy = energy(static_cast<int>(Blocked.size())), Best_Energy = Current_Energy;
+		Save_Best();
+
+		//The temperature falls geometrically with the time spent, from twice the weight of one Maximum Frequency Slot Index to one Path Distance slot:
+		mt19937 Generator(Seed);
+		uniform_real_distribution<double> Uniform(0.0, 1.0);
+		const double Initial_Temperature = 2.0 * (static_cast<double>(_spectrum.get_link_num()) * _spectrum.get_slot_num() + 1);
+		long long Move_Num = 0, Accepted_Num = 0;
+		vector<int> Ruined, Ruin_Order;
+		vector<Allocation> Ruined_Allocation;
+		vector<Embedding_Result> Ruined_Record;
+		VONESpectrum::Spectrum_Transaction Move_Undo;
+		vector<Utilited_Vertex> Vertex_Snapshot;
+		vector<int> Position_Snapshot;
+		while (VN_Num > 0)
 		{
-			Utilited_Edge tmp;
-			tmp._edge = *iter;
+			double Elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - Start_Time).count();
+			if (Elapsed >= Time_Budget)
+				break;
+			double Temperature = Initial_Temperature * pow(1.0 / Initial_Temperature, Elapsed / Time_Budget);
+			Move_Num++;
 
-			for (int i = 1; i <= CoreNumber; i++)
+			int Move = Generator() % 5;
+			if (Move == 0 && !Blocked.empty())
+			{
+				//Insert a blocked virtual network, which always lowers the objective:
+				int b = Generator() % Blocked.size();
+				Embedding_Result Record = embed(Virtual_Network_List[Blocked[b]]);
+				if (Record._handle == -1)
+					continue;
+				Current[Blocked[b]] = Record;
+				Blocked[b] = Blocked.back();
+				Blocked.pop_back();
+				Current_Energy = energy(static_cast<int>(Blocked.size()));
+				Accepted_Num++;
+			}
+			else if (Move == 1)
+			{
+				//Shift the frequency slots of one virtual network to a lower start, which never raises the objective:
+				int i = Generator() % VN_Num;
+				if (Current[i]._handle == -1 || !repack(_allocation[Current[i]._handle]))
+					continue;
+				const Allocation& Record = _allocation[Current[i]._handle];
+				Current[i]._start_frequency = Record._start_frequency;
+				for (int h = 0; h < Record._hop_num; h++)
+					Current[i]._core[h] = Record._resource[2 * (Record._vertex_num + h) + 1];
+				Current_Energy = energy(static_cast<int>(Blocked.size()));
+				Accepted_Num++;
+			}
+			else if (Move == 2)
+			{
+				//Swap the core of one hop of one virtual network for another allowed core at the same start frequency slot, 
+				//    which may lower the End Frequency Slot of the core it leaves:
+				int i = Generator() % VN_Num;
+				if (Current[i]._handle == -1)
+					continue;
+				Allocation& Record = _allocation[Current[i]._handle];
+				int Hop = Generator() % Record._hop_num, Old_Core = Record._resource[2 * (Record._vertex_num + Hop) + 1] / 2 + 1;
+				_undo = &Move_Undo;
+				bool Swapped = swap_core(Record, Hop, 1 + Generator() % _spectrum.get_core_num());
+				_undo = NULL;
+				if (!Swapped)
+					continue;
+
+				long long New_Energy = energy(static_cast<int>(Blocked.size()));
+				if (New_Energy <= Current_Energy || Uniform(Generator) < exp((Current_Energy - New_Energy) / Temperature))
+				{
+					Move_Undo.commit();
+					Current[i]._core[Hop] = Record._resource[2 * (Record._vertex_num + Hop) + 1];
+					Current_Energy = New_Energy;
+					Accepted_Num++;
+				}
+				else
+				{
+					swap_core(Record, Hop, Old_Core);
+					Move_Undo.rollback();
+				}
+			}
+			else
 			{
-				vector<int> frequency_tmp(iter->_edge_bandwidth);
-				tmp._frequency.push_back(frequency_tmp); //Link smaller source to bigger destination
-				tmp._frequency.push_back(frequency_tmp); //Link bigger source to smaller destination
-				tmp._end_slot.push_back(1);
+				//Release up to three virtual networks and embed them again in a random order, 
+				//    which may give them other substrate nodes, paths, cores and start frequency slots:
+				Ruined.clear();
+				int Ruin_Num = 1 + Generator() % 3;
+				for (int attempt = 0; attempt < 4 * Ruin_Num && static_cast<int>(Ruined.size()) < Ruin_Num; attempt++)
+				{
+					int i = Generator() % VN_Num;
+					if (Current[i]._handle != -1 && find(Ruined.begin(), Ruined.end(), i) == Ruined.end())
+						Ruined.push_back(i);
+				}
+				if (Ruined.empty())
+					continue;
+
+				//The End Frequency Slots and the Path Distances changed by the move are recorded, and the order of the substrate nodes, 
+				//    which each embedding sorts in full anyway, is kept, so that a rejected move leaves the substrate state exactly as it was:
+				Vertex_Snapshot = _sn_vertex;
+				Position_Snapshot = _sn_position;
+				_undo = &Move_Undo;
+				Ruined_Allocation.clear();
+				Ruined_Record.clear();
+				for (vector<int>::const_iterator iter = Ruined.begin(); iter != Ruined.end(); iter++)
+				{
+					Ruined_Allocation.push_back(_allocation[Current[*iter]._handle]);
+					Ruined_Record.push_back(Current[*iter]);
+					release(Current[*iter]._handle);
+				}
+				Ruin_Order = Ruined;
+				shuffle(Ruin_Order.begin(), Ruin_Order.end(), Generator);
+				int Block_Num = static_cast<int>(Blocked.size());
+				for (vector<int>::const_iterator iter = Ruin_Order.begin(); iter != Ruin_Order.end(); iter++)
+				{
+					Current[*iter] = embed(Virtual_Network_List[*iter]);
+					if (Current[*iter]._handle == -1)
+						Block_Num++;
+				}
+				_undo = NULL;
+
+				long long New_Energy = energy(Block_Num);
+				if (New_Energy <= Current_Energy || Uniform(Generator) < exp((Current_Energy - New_Energy) / Temperature))
+				{
+					for (vector<int>::const_iterator iter = Ruined.begin(); iter != Ruined.end(); iter++)
+					{
+						if (Current[*iter]._handle == -1)
+							Blocked.push_back(*iter);
+					}
+					Move_Undo.commit();
+					Current_Energy = New_Energy;
+					Accepted_Num++;
+				}
+				else
+				{
+					//Undo the move by giving back the new embedding and taking the old one again, and then writing back 
+					//    the End Frequency Slots and the Path Distances, which leaves Current_Energy as it was before the move:
+					for (vector<int>::const_iterator iter = Ruined.begin(); iter != Ruined.end(); iter++)
+					{
+						if (Current[*iter]._handle != -1)
+							release(Current[*iter]._handle);
+					}
+					for (int k = 0; k < static_cast<int>(Ruined.size()); k++)
+					{
+						Current[Ruined[k]] = Ruined_Record[k];
+						Current[Ruined[k]]._handle = restore(Ruined_Allocation[k]);
+					}
+					Move_Undo.rollback();
+					_sn_vertex = Vertex_Snapshot;
+					_sn_position = Position_Snapshot;
+				}
 			}
-			tmp._path_distance = 1;
 
-			SN_Utilited_Edge.push_back(tmp);
+			if (Current_Energy < Best_Energy)
+			{
+				Best_Energy = Current_Energy;
+				Save_Best();
+			}
 		}
 
-		//Sort the virtual networks according to the vertex size and edge size:
-		sort(Virtual_Network_List.begin(), Virtual_Network_List.end(), VNcompare);
+		//The substrate state is given back from the best solution when the search has left it:
+		if (Current_Energy > Best_Energy)
+		{
+			_spectrum = Best_Spectrum;
+			_sn_vertex = Best_Vertex;
+			_sn_position = Best_Position;
+			_allocation.clear();
+			_free_handle.clear();
+			Current = Best;
+			for (int i = 0; i < VN_Num; i++)
+			{
+				if (Best_Allocation[i]._vertex_num == 0)
+					continue;
+				Current[i]._handle = new_handle();
+				_allocation[Current[i]._handle] = Best_Allocation[i];
+			}
+		}
 
-		for (vector<VONETopo::Topo>::iterator iter = Virtual_Network_List.begin(); iter != Virtual_Network_List.end(); iter++)
+		_request_num = VN_Num;
+		_result_sink = Sink;
+		int Block_Num = 0;
+		for (int i = 0; i < VN_Num; i++)
 		{
-			fout << "Sorted Virtual Request Topology " << iter - Virtual_Network_List.begin() + 1 << " are following:\n";
-			fout << *iter << endl;
+			bool blocked = (Current[i]._handle == -1);
+			_vertex_embedding_result.push_back(blocked ? vector<int>() : Current[i]._vertex);
+			_edge_embedding_result.push_back(blocked ? vector<vector<int> >() : Current[i]._edge);
+			_core_assignment_result.push_back(blocked ? vector<int>() : Current[i]._core);
+			_start_frequency_result.push_back(blocked ? 0 : Current[i]._start_frequency);
+			if (blocked)
+				Block_Num++;
+			if (_result_sink != NULL)
+				_result_sink->write_request(i + 1, Current[i]);
 		}
+		_block_num += Block_Num;
+		if (_result_sink != NULL)
+			_result_sink->write_summary(VN_Num, Block_Num, _spectrum);
 
-		//Core Priority:
-		vector<int> Core_Priority(CoreNumber);
-		if ((CrosstalkYesorNo == "Yes") || (CrosstalkYesorNo == "yes"))
+		VONE_LOG(Log, VONELog::Log_Info) << "Simulated annealing has made " << Move_Num << " moves and accepted " << Accepted_Num 
+			<< ", the blocks have gone from " << Greedy_Block << " to " << Block_Num << " and the Maximum Frequency Slot Index from " 
+			<< Greedy_Max_Slot << " to " << Max_Slot_Index(_spectrum) << "\n";
+	}
+
+	void VONEHeuristic::solve_parallel(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List, 
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, const int Thread_Num)
+	{
+		if (Thread_Num < 0)
+		{
+			cerr << "Number of threads should not be negative!\n";
+			exit(1);
+		}
+		VONELog::Logger Log("log.dat", _log_level);
+		sort(Virtual_Network_List.begin(), Virtual_Network_List.end(), VNcompare);
+
+		int Worker_Num = Thread_Num > 0 ? Thread_Num : max(1, static_cast<int>(thread::hardware_concurrency()));
+		solve_ordered(Substrate_Network, Virtual_Network_List, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Log, Worker_Num);
+	}
+
+	void VONEHeuristic::solve_concurrent(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List, 
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, const int Thread_Num)
+	{
+		if (Thread_Num < 0)
+		{
+			cerr << "Number of threads should not be negative!\n";
+			exit(1);
+		}
+		VONELog::Logger Log("log.dat", _log_level);
+		sort(Virtual_Network_List.begin(), Virtual_Network_List.end(), VNcompare);
+		prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Log);
+
+		//Each thread embeds the virtual networks handed out to it on its own replica of the substrate state, which catches up 
+		//    with the allocations committed by the other threads before each try, and then commits the allocation to the shared state. 
+		//    A conflict means another thread has taken some of the same resources since, so the allocation is released and tried again. 
+		//    So does a commit by another thread after the catching up, even on other resources, since the replica has chosen 
+		//    the nodes, the paths and the cores on a state which is no longer the last one. A blocked virtual network is committed as well, 
+		//    with no resources, since its vertexes embedding has sorted the substrate nodes, which breaks the ties of the later ones:
+		int VN_Num = static_cast<int>(Virtual_Network_List.size());
+		Shared_Substrate Shared(Substrate_Network, _spectrum, VN_Num);
+		vector<Embedding_Result> Result(VN_Num);
+		atomic<int> Next_Request(0);
+		atomic<long long> Conflict_Num(0);
+		const Allocation Blocked_Allocation = Allocation();
+		auto Worker = [&](const int Owner)
 		{
-			for (int i = 1; i <= Core_Priority.size(); i++)
+			VONEHeuristic Replica;
+			VONESpectrum::Spectrum_Transaction Try_Undo;
+			vector<Utilited_Vertex> Vertex_Snapshot;
+			vector<int> Position_Snapshot;
+			share_path_candidate(Replica);
+			Replica.prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Silent_Log);
+			int applied = 0;
+			for (int request = Next_Request++; request < VN_Num; request = Next_Request++)
 			{
-				Core_Priority[i - 1] = i;
+				while (true)
+				{
+					for (; applied < VN_Num && Shared._commit_owner[applied].load(memory_order_acquire) != -1; applied++)
+					{
+						if (Shared._commit_owner[applied].load(memory_order_relaxed) != Owner)
+							Replica.restore_ranked(Shared._commit_log[applied]);
+					}
+
+					//The order of the substrate nodes is kept, and the End Frequency Slots and the Path Distances changed are recorded, 
+					//    since a release does not give them back, so that a try given up leaves the replica as it was:
+					Vertex_Snapshot = Replica._sn_vertex;
+					Position_Snapshot = Replica._sn_position;
+					Replica._undo = &Try_Undo;
+					Embedding_Result Record = Replica.embed(Virtual_Network_List[request]);
+					Replica._undo = NULL;
+					bool blocked = (Record._handle == -1);
+					const Allocation& Taken = blocked ? Blocked_Allocation : Replica._allocation[Record._handle];
+					int commit = applied;
+					if (Shared._commit_num.load(memory_order_acquire) == applied && (blocked || Reserve_Allocation(Shared, Taken)))
+					{
+						if (Shared._commit_num.compare_exchange_strong(commit, applied + 1, memory_order_acq_rel))
+						{
+							Shared._commit_log[applied] = Taken;
+							Shared._commit_request[applied] = request;
+							Shared._commit_owner[applied].store(Owner, memory_order_release);
+							Result[request] = Record;
+							Try_Undo.commit();
+							break;
+						}
+						if (!blocked)
+							Return_Allocation(Shared, Taken);
+					}
+					if (!blocked)
+						Replica.release(Record._handle);
+					Try_Undo.rollback();
+					Replica._sn_vertex = Vertex_Snapshot;
+					Replica._sn_position = Position_Snapshot;
+					Conflict_Num++;
+					this_thread::yield();
+				}
 			}
+		};
+
+		int Worker_Num = Thread_Num > 0 ? Thread_Num : max(1, static_cast<int>(thread::hardware_concurrency()));
+		Worker_Num = max(1, min(Worker_Num, VN_Num));
+		vector<thread> Pool;
+		for (int i = 1; i < Worker_Num; i++)
+			Pool.push_back(thread(Worker, i));
+		Worker(0);
+		for (vector<thread>::iterator iter = Pool.begin(); iter != Pool.end(); iter++)
+			iter->join();
+
+		//The substrate state here is built by taking the committed allocations again in the order of the commit log, 
+		//    so the handles in the results can be released from this heuristic:
+		int Commit_Num = Shared._commit_num.load();
+		for (int commit = 0; commit < Commit_Num; commit++)
+		{
+			int handle = restore_ranked(Shared._commit_log[commit]);
+			if (Result[Shared._commit_request[commit]]._handle != -1)
+				Result[Shared._commit_request[commit]]._handle = handle;
 		}
-		else
-			Core_Priority_Define(Core_Priority, HeterogeneousCoreIndex, CoreNumber, fout);
+		_request_num = VN_Num;
 
-		//Core Classfication:
-		vector<int> Core_Classification(CoreNumber);
-		if (HeterogeneousCoreIndex == 0)
-		{			
-			if ((CrosstalkYesorNo == "No") || (CrosstalkYesorNo == "no"))
-			{
-				vector<int> Service_Type = { 1, 2, 3 };
-				Core_Classification_Define(Core_Classification, Core_Priority, Service_Type, CoreNumber, fout);
-			}				
+		int Block_Num = 0;
+		for (int i = 0; i < VN_Num; i++)
+		{
+			bool blocked = (Result[i]._handle == -1);
+			_vertex_embedding_result.push_back(blocked ? vector<int>() : Result[i]._vertex);
+			_edge_embedding_result.push_back(blocked ? vector<vector<int> >() : Result[i]._edge);
+			_core_assignment_result.push_back(blocked ? vector<int>() : Result[i]._core);
+			_start_frequency_result.push_back(blocked ? 0 : Result[i]._start_frequency);
+			if (blocked)
+				Block_Num++;
+			if (_result_sink != NULL)
+				_result_sink->write_request(i + 1, Result[i]);
 		}
-		else
-		{			
-			if ((CrosstalkYesorNo == "No") || (CrosstalkYesorNo == "no"))
+		_block_num += Block_Num;
+		if (_result_sink != NULL)
+			_result_sink->write_summary(VN_Num, Block_Num, _spectrum);
+
+		VONE_LOG(Log, VONELog::Log_Info) << "Concurrent embedding on " << Worker_Num << " threads has committed " << Commit_Num - Block_Num 
+			<< " virtual networks and blocked " << Block_Num << ", with " << Conflict_Num.load() << " conflicts tried again\n";
+	}
+
+	void VONEHeuristic::solve_ordered(const VONETopo::Topo& Substrate_Network, const vector<VONETopo::Topo>& Virtual_Network_List, 
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, VONELog::Logger& Log, const int Thread_Num)
+	{
+		if (VONE_LOG_ON(Log, VONELog::Log_Trace))
+		{
+			ostream& outs = Log.stream();
+			for (vector<VONETopo::Topo>::const_iterator iter = Virtual_Network_List.begin(); iter != Virtual_Network_List.end(); iter++)
 			{
-				vector<int> Service_Type = { 1, 3 };
-				Core_Classification_Define(Core_Classification, Core_Priority, Service_Type, CoreNumber, fout);
-			}			
+				outs << "Sorted Virtual Request Topology " << iter - Virtual_Network_List.begin() + 1 << " are following:\n";
+				outs << *iter << endl;
+			}
 		}
 
-		//Embedding start:
-		for (vector<VONETopo::Topo>::iterator titer = Virtual_Network_List.begin();
+		prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Log);
+		vector<Embedding_Result> Wave_Record;
+		if (Thread_Num > 1)
+			embed_in_waves(Substrate_Network, Virtual_Network_List, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Thread_Num, Wave_Record, Log);
+
+		//Embedding start, where the computing resource taken by a blocked virtual network is kept as before:
+		for (vector<VONETopo::Topo>::const_iterator titer = Virtual_Network_List.begin();
 			titer != Virtual_Network_List.end(); titer++)
 		{
-			//Vertexes embedding:	
-			VONETopo::NodeList VNNode;
-			titer->get_vertex(VNNode);
-			vector<int> vertex_embedding_result;
-			Vertexes_Embedding(VNNode, SN_Utilited_Vertex, vertex_embedding_result, fout);
-			_vertex_embedding_result.push_back(vertex_embedding_result);
-			if (vertex_embedding_result.empty())
+			Embedding_Result Record;
+			if (Thread_Num > 1)
+				Record = move(Wave_Record[titer - Virtual_Network_List.begin()]);
+			else
+				embed_request(*titer, Record, false, Log);
+			_request_num++;
+			if (_result_sink != NULL)
+				_result_sink->write_request(_request_num, Record);
+
+			//Vertexes embedding:
+			_vertex_embedding_result.push_back(Record._vertex);
+			if (Record._vertex.empty())
 			{
 				_block_num++;
 				continue;
 			}
 
 			//Edges embedding:
-			VONETopo::LinkList VNLink;
-			titer->get_edge(VNLink);
-			vector<vector<int> > edge_embedding_result;
-			Edges_Embedding(VNLink, static_cast<const int>(SN_Utilited_Vertex.size()), SN_Utilited_Edge, vertex_embedding_result, edge_embedding_result, fout);
-			_edge_embedding_result.push_back(edge_embedding_result);
-			if (edge_embedding_result.empty())
+			_edge_embedding_result.push_back(Record._edge);
+			if (Record._edge.empty())
 			{
 				_block_num++;
 				_vertex_embedding_result[titer - Virtual_Network_List.begin()].clear();
@@ -209,83 +722,750 @@ namespace VONEHeuristic
 			}
 
 			//Core Assignment:
-			vector<int> core_assignment_result;
-			int start_frequency_result = 0;
-			int VN_Bandwidth = VNLink[0]._edge_bandwidth;
-			Core_Assignment(edge_embedding_result, Core_Priority, HeterogeneousCoreIndex,
-				SN_Utilited_Edge, Core_Classification, VN_Bandwidth,
-				core_assignment_result, start_frequency_result, CoreNumber, fout);
-			_core_assignment_result.push_back(core_assignment_result);
-			_start_frequency_result.push_back(start_frequency_result);
-			if (core_assignment_result.empty())
+			_core_assignment_result.push_back(Record._core);
+			_start_frequency_result.push_back(Record._start_frequency);
+			if (Record._core.empty())
 			{
 				_block_num++;
 				_vertex_embedding_result[titer - Virtual_Network_List.begin()].clear();
-				_edge_embedding_result[titer - Virtual_Network_List.begin()].clear();
+				_edge_embedding_result.back().clear();
 				continue;
 			}
+		}
+
+		if (_result_sink != NULL)
+			_result_sink->write_summary(_request_num, _block_num, _spectrum);
+	}
+
+	void VONEHeuristic::prepare(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout, 
+		int HeterogeneousCoreIndex, string CrosstalkYesorNo)
+	{
+		prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, _logger != NULL ? *_logger : Silent_Log);
+	}
+
+	Embedding_Result VONEHeuristic::embed(const VONETopo::Topo& Virtual_Network)
+	{
+		Embedding_Result Record;
+		_request_num++;
+		if (!embed_request(Virtual_Network, Record, true, _logger != NULL ? *_logger : Silent_Log))
+		{
+			if (_result_sink != NULL)
+				_result_sink->write_request(_request_num, Record);
+			return Record;
+		}
+
+		int Handle = new_handle();
+		pack(Virtual_Network, Record, _allocation[Handle]);
+		Record._handle = Handle;
+		if (_result_sink != NULL)
+			_result_sink->write_request(_request_num, Record);
+		return Record;
+	}
+
+	void VONEHeuristic::release(const int Handle)
+	{
+		if (Handle < 0 || Handle >= static_cast<int>(_allocation.size()) || _allocation[Handle]._vertex_num == 0)
+		{
+			cerr << "Virtual network " << Handle << " has not been embedded!\n";
+			exit(1);
+		}
+		VONE_PROFILE_SCOPE(VONEProfile::Phase_Frequency_Recovery);
+		Allocation& Record = _allocation[Handle];
+		const int* resource = Record._resource.data();
 
-			//Frequency Allocating:
-			Frequency_Allocating(edge_embedding_result, core_assignment_result, 
-				start_frequency_result, HeterogeneousCoreIndex, SN_Utilited_Edge, VN_Bandwidth);
+		//Return the computing resource, the positions of the substrate nodes are kept since they were last sorted:
+		for (int v = 0; v < Record._vertex_num; v++, resource += 2)
+		{
+			_sn_vertex[_sn_position[resource[0]]]._remaining_computing_resource += resource[1];
+		}
+
+		//Return the frequency slots hop by hop, the End Frequency Slots follow the same rule as in Frequency_Allocating:
+		VONESpectrum::Spectrum_Arena& SN_Spectrum = _spectrum;
+		for (int h = 0; h < Record._hop_num; h++, resource += 2)
+		{
+			int edge_index = resource[0], core_index = resource[1];
+			SN_Spectrum.unassign(edge_index, core_index, Record._start_frequency, Record._width, _layout.crosstalk_mask(core_index / 2 + 1, _hetergeneous_core));
+			SN_Spectrum.occupancy(edge_index, core_index).release(Record._start_frequency, Record._width);
+			Update_End_Slot(SN_Spectrum, edge_index, core_index, _undo);
 		}
 
-		//Storing the frequency status of each substrate network link:
-		for (vector<Utilited_Edge>::iterator iter = SN_Utilited_Edge.begin();
-			iter != SN_Utilited_Edge.end(); iter++)
+		Record._vertex_num = 0;
+		Record._hop_num = 0;
+		Record._resource.clear();
+		_free_handle.push_back(Handle);
+	}
+
+	void VONEHeuristic::set_path_candidate_num(const int K)
+	{
+		if (K < 0)
 		{
-			_frequency_allocating_result.push_back(iter->_frequency);
+			cerr << "Number of candidate paths should not be negative!\n";
+			exit(1);
 		}
+		_path_candidate_num = K;
+		build_path_candidate(_substrate);
+	}
+
+	void VONEHeuristic::set_log_level(const VONELog::Log_Level Level)
+	{
+		_log_level = Level;
+	}
+
+	void VONEHeuristic::set_logger(VONELog::Logger* Log)
+	{
+		_logger = Log;
+	}
+
+	void VONEHeuristic::set_result_sink(VONEResult::Result_Sink* Sink)
+	{
+		_result_sink = Sink;
+	}
+
+	void VONEHeuristic::set_spectrum_dump(const bool Dump)
+	{
+		_spectrum_dump = Dump;
+	}
+
+	int VONEHeuristic::defragment(const double Time_Budget)
+	{
+		chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + 
+			chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(Time_Budget));
 
-		//Counting the maximum frequency slot and fragmetation of each core in each substrate network link:
-		for (unsigned int i = 1; i <= _frequency_allocating_result.size(); i++)
+		//The virtual networks are tried from the highest last frequency slot down, and only those holding 
+		//    the Maximum Frequency Slot Index of a core and direction, since moving the others lowers no index:
+		vector<pair<int, int> > candidate;
+		for (vector<Allocation>::const_iterator iter = _allocation.begin(); iter != _allocation.end(); iter++)
 		{
-			vector<int> tmp1;
-			vector<int> tmp2;
-			int crosstalk = 0;
-			for (unsigned int j = 1; j <= _frequency_allocating_result[i-1].size(); j++)
+			if (iter->_vertex_num == 0)
+				continue;
+			int last_slot = iter->_start_frequency + iter->_width - 1;
+			const int* hop = iter->_resource.data() + 2 * iter->_vertex_num;
+			for (int h = 0; h < iter->_hop_num; h++, hop += 2)
 			{
-				for (int k = static_cast<int>(_frequency_allocating_result[i - 1][j - 1].size()); k >= 1; k--)
+				if (_spectrum.highest_used_slot(hop[0], hop[1]) == last_slot)
 				{
-					if (_frequency_allocating_result[i - 1][j - 1][k - 1] != 0)
-					{
-						tmp1.push_back(k);
-						break;
-					}
-					else if (k == 1)
-					{
-						tmp1.push_back(0);
-					}
-					else
+					candidate.push_back(make_pair(last_slot, static_cast<int>(iter - _allocation.begin())));
+					break;
+				}
+			}
+		}
+		sort(candidate.begin(), candidate.end(), greater<pair<int, int> >());
+
+		int moved_num = 0;
+		for (vector<pair<int, int> >::const_iterator iter = candidate.begin(); iter != candidate.end(); iter++)
+		{
+			if (chrono::steady_clock::now() >= deadline)
+				break;
+			if (repack(_allocation[iter->second]))
+				moved_num++;
+		}
+		return moved_num;
+	}
+
+	int VONEHeuristic::get_active_num() const
+	{
+		return static_cast<int>(_allocation.size() - _free_handle.size());
+	}
+
+	void VONEHeuristic::embed_in_waves(const VONETopo::Topo& Substrate_Network, const vector<VONETopo::Topo>& Virtual_Network_List, 
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, const int Thread_Num, 
+		vector<Embedding_Result>& Record, VONELog::Logger& Log)
+	{
+		//The computing resource taken by each virtual network does not depend on its links, since a blocked one keeps it, 
+		//    so the vertexes embedding runs first for all of them in order, and only the links are embedded in waves:
+		int VN_Num = static_cast<int>(Virtual_Network_List.size());
+		Record.assign(VN_Num, Embedding_Result());
+		for (int i = 0; i < VN_Num; i++)
+			embed_vertexes(Virtual_Network_List[i], Record[i], false, Log);
+
+		//Each thread speculates the core assignments of the virtual networks of a wave, the first one on the real spectrum 
+		//    and the others on their own replicas. A replica is prepared once, and catches up at the beginning of each wave 
+		//    by allocating the frequency slots committed since its last wave, so it holds the same spectrum as the real one:
+		int Wave_Size = Thread_Num * Wave_Factor;
+		vector<Embedding_Result> Speculation(Wave_Size);
+		vector<int> Speculated_Rank(Wave_Size);
+		vector<VONEHeuristic> Replica(Thread_Num - 1);
+		for (vector<VONEHeuristic>::iterator iter = Replica.begin(); iter != Replica.end(); iter++)
+		{
+			share_path_candidate(*iter);
+			iter->prepare(Substrate_Network, Layout, HeterogeneousCoreIndex, CrosstalkYesorNo, Silent_Log);
+		}
+
+		mutex Wave_Mutex;
+		condition_variable Wave_Begun, Wave_Ended;
+		int Wave_Generation = 0, Wave_Begin = 0, Wave_Num = 0, Wave_Pending = 0;
+		bool Wave_Stop = false;
+		atomic<int> Wave_Next(0);
+		auto Speculate = [&](VONEHeuristic& Heuristic)
+		{
+			for (int k = Wave_Next++; k < Wave_Num; k = Wave_Next++)
+			{
+				Speculation[k] = Record[Wave_Begin + k];
+				Speculated_Rank[k] = 0;
+				if (Speculation[k]._block_reason == Not_Blocked)
+					Heuristic.embed_links(Virtual_Network_List[Wave_Begin + k], Speculation[k], false, Silent_Log, &Speculated_Rank[k]);
+			}
+		};
+		auto Worker = [&](const int Worker)
+		{
+			VONEHeuristic& replica = Replica[Worker - 1];
+			VONETopo::LinkList VNLink;
+			int generation = 0, caught = 0;
+			while (true)
+			{
+				{
+					unique_lock<mutex> lock(Wave_Mutex);
+					Wave_Begun.wait(lock, [&]() { return Wave_Stop || Wave_Generation != generation; });
+					if (Wave_Stop)
+						return;
+					generation = Wave_Generation;
+				}
+				for (; caught < Wave_Begin; caught++)
+				{
+					const Embedding_Result& Committed = Record[caught];
+					if (Committed._block_reason != Not_Blocked)
 						continue;
+					Virtual_Network_List[caught].get_edge(VNLink);
+					Frequency_Allocating(replica._substrate, Committed._edge, Committed._core, Committed._start_frequency, 
+						replica._hetergeneous_core, replica._layout, replica._spectrum, VNLink[0]._edge_bandwidth);
 				}
+				Speculate(replica);
+				lock_guard<mutex> lock(Wave_Mutex);
+				if (--Wave_Pending == 0)
+					Wave_Ended.notify_one();
+			}
+		};
+		vector<thread> Pool;
+		for (int i = 1; i < Thread_Num; i++)
+			Pool.push_back(thread(Worker, i));
+
+		//The virtual networks are then committed here in their order. The edges embedding runs again on the real spectrum, 
+		//    and the core assignment takes the speculated one as long as it is still exact, so every virtual network is embedded 
+		//    exactly as in the serial order:
+		int Kept_Num = 0;
+		for (int begin = 0; begin < VN_Num; begin += Wave_Size)
+		{
+			{
+				lock_guard<mutex> lock(Wave_Mutex);
+				Wave_Begin = begin;
+				Wave_Num = min(Wave_Size, VN_Num - begin);
+				Wave_Next = 0;
+				Wave_Pending = Thread_Num - 1;
+				Wave_Generation++;
+			}
+			Wave_Begun.notify_all();
+			Speculate(*this);
+			{
+				unique_lock<mutex> lock(Wave_Mutex);
+				Wave_Ended.wait(lock, [&]() { return Wave_Pending == 0; });
+			}
+
+			for (int k = 0; k < Wave_Num; k++)
+			{
+				const VONETopo::Topo& Virtual_Network = Virtual_Network_List[begin + k];
+				Embedding_Result& Current = Record[begin + k];
+				if (Current._block_reason == Vertex_Blocked)
+					continue;
+				bool embedded = embed_links(Virtual_Network, Current, false, Log, NULL, &Speculation[k], Speculated_Rank[k]);
+				if (Current._core == Speculation[k]._core && Current._start_frequency == Speculation[k]._start_frequency)
+					Kept_Num++;
+				if (embedded)
+					allocate_frequency(Virtual_Network, Current);
+			}
+		}
+
+		{
+			lock_guard<mutex> lock(Wave_Mutex);
+			Wave_Stop = true;
+		}
+		Wave_Begun.notify_all();
+		for (vector<thread>::iterator iter = Pool.begin(); iter != Pool.end(); iter++)
+			iter->join();
+
+		VONE_LOG(Log, VONELog::Log_Info) << "Parallel embedding on " << Thread_Num << " threads has kept " << Kept_Num 
+			<< " speculated core assignments of " << VN_Num << " virtual networks\n";
+	}
+
+	void VONEHeuristic::prepare(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout, 
+		int HeterogeneousCoreIndex, string CrosstalkYesorNo, VONELog::Logger& Log)
+	{
+		int CoreNumber = Layout.get_core_num();
+		_substrate = Substrate_Network;
+		_layout = Layout;
+		_hetergeneous_core = HeterogeneousCoreIndex;
+		_request_num = 0;
+		_block_num = 0;
+		_allocation.clear();
+		_free_handle.clear();
+		_vertex_embedding_result.clear();
+		_edge_embedding_result.clear();
+		_core_assignment_result.clear();
+		_start_frequency_result.clear();
+
+		//Initialize the utilited vertex of the substrate network:
+		_sn_vertex.clear();
+		_sn_position.clear();
+		VONETopo::NodeList SN_Vertex;
+		Substrate_Network.get_vertex(SN_Vertex);
+		for (VONETopo::NodeListIT iter = SN_Vertex.begin(); iter != SN_Vertex.end(); iter++)
+		{
+			Utilited_Vertex tmp;
+			tmp._vertex = *iter;
+			tmp._remaining_computing_resource = iter->_vertex_computing_capacity;
+			_sn_position.push_back(static_cast<int>(_sn_vertex.size()));
+			_sn_vertex.push_back(tmp);
+		}
+
+		//Initialize the spectrum of the substrate network in one arena, with the links in the same order as the edges in 
+		//    Substrate_Network so that the index returned by find_edge addresses the link directly. All links share the 
+		//    frequency slot number of the first edge, which bounds the start frequency slot as well:
+		VONETopo::LinkList SN_Edge;
+		Substrate_Network.get_edge(SN_Edge);
+		_spectrum = VONESpectrum::Spectrum_Arena(static_cast<int>(SN_Edge.size()), CoreNumber, 
+			SN_Edge.empty() ? 0 : SN_Edge[0]._edge_bandwidth);
+
+		//The graph of the substrate network is built once, and only its weights are refreshed for each VN:
+		_sn_resource = VONETopo::Graph(static_cast<int>(_sn_vertex.size()), SN_Edge);
 
-				int fragmentation = 0;
-				for (int k = 1; k <= tmp1[j-1]; k++)
+		//Core Priority:
+		Crosstalk_Policy Crosstalk = Parse_Crosstalk(CrosstalkYesorNo);
+		_core_priority.assign(CoreNumber, 0);
+		if (Crosstalk == Crosstalk_Allowed)
+		{
+			for (int i = 1; i <= _core_priority.size(); i++)
+			{
+				_core_priority[i - 1] = i;
+			}
+		}
+		else
+			Core_Priority_Define(_core_priority, HeterogeneousCoreIndex, Layout, Log);
+
+		//Core Classfication:
+		_core_classification.assign(CoreNumber, 0);
+		if (HeterogeneousCoreIndex == 0)
+		{			
+			if (Crosstalk == Crosstalk_Avoided)
+			{
+				vector<int> Service_Type = { 1, 2, 3 };
+				Core_Classification_Define(_core_classification, _core_priority, Service_Type, Layout, Log);
+			}				
+		}
+		else
+		{			
+			if (Crosstalk == Crosstalk_Avoided)
+			{
+				vector<int> Service_Type = { 1, 3 };
+				Core_Classification_Define(_core_classification, _core_priority, Service_Type, Layout, Log);
+			}			
+		}
+		Core_Table_Define(_core_table, _core_priority, _core_classification, HeterogeneousCoreIndex);
+		build_path_candidate(Substrate_Network);
+	}
+
+	void VONEHeuristic::build_path_candidate(const VONETopo::Topo& Substrate_Network)
+	{
+		if (_path_candidate_num == 0)
+		{
+			_path_candidate.reset();
+			return;
+		}
+
+		//The candidates follow the initial weights of the graph, which are the frequency slot numbers of the edges, 
+		//    so they only depend on the nodes, the edges and their frequency slot numbers:
+		VONETopo::NodeList SN_Vertex;
+		Substrate_Network.get_vertex(SN_Vertex);
+		VONETopo::LinkList SN_Edge;
+		Substrate_Network.get_edge(SN_Edge);
+		int vertex_num = static_cast<int>(SN_Vertex.size());
+		vector<array<int, 3> > edge;
+		edge.reserve(SN_Edge.size());
+		for (VONETopo::LinkListIT iter = SN_Edge.begin(); iter != SN_Edge.end(); iter++)
+		{
+			array<int, 3> tmp = { iter->_edge_source._vertex_id, iter->_edge_destination._vertex_id, iter->_edge_bandwidth };
+			edge.push_back(tmp);
+		}
+		if (_path_candidate && _path_candidate->_k == _path_candidate_num && _path_candidate->_vertex_num == vertex_num 
+			&& _path_candidate->_edge == edge)
+			return;
+
+		shared_ptr<Path_Candidate> candidate = make_shared<Path_Candidate>();
+		candidate->_k = _path_candidate_num;
+		candidate->_vertex_num = vertex_num;
+		candidate->_edge.swap(edge);
+		VONETopo::Graph SN_Graph(vertex_num, SN_Edge);
+		candidate->_path.resize(vertex_num * vertex_num);
+		for (int source = 1; source <= vertex_num; source++)
+		{
+			for (int destination = 1; destination <= vertex_num; destination++)
+			{
+				if (source != destination)
+					SN_Graph.K_Shortest_Paths(source, destination, _path_candidate_num, candidate->_path[(source - 1) * vertex_num + destination - 1]);
+			}
+		}
+		_path_candidate = candidate;
+	}
+
+	void VONEHeuristic::share_path_candidate(VONEHeuristic& Replica) const
+	{
+		Replica._path_candidate_num = _path_candidate_num;
+		Replica._path_candidate = _path_candidate;
+	}
+
+	bool VONEHeuristic::embed_request(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record, const bool Return_on_Block, VONELog::Logger& Log)
+	{
+		if (!embed_vertexes(Virtual_Network, Record, Return_on_Block, Log) || !embed_links(Virtual_Network, Record, Return_on_Block, Log))
+			return false;
+		allocate_frequency(Virtual_Network, Record);
+		return true;
+	}
+
+	bool VONEHeuristic::embed_vertexes(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record, const bool Return_on_Block, VONELog::Logger& Log)
+	{
+		Record._handle = -1;
+		Record._block_reason = Not_Blocked;
+		Record._start_frequency = 0;
+		Record._width = 0;
+		Record._service_type = 0;
+
+		//Vertexes embedding:	
+		VONETopo::NodeList VNNode;
+		Virtual_Network.get_vertex(VNNode);
+		Vertexes_Embedding(VNNode, _sn_vertex, Record._vertex, Return_on_Block, Log);
+		for (vector<Utilited_Vertex>::const_iterator iter = _sn_vertex.begin(); iter != _sn_vertex.end(); iter++)
+		{
+			_sn_position[_substrate.find_vertex(iter->_vertex._vertex_id)] = static_cast<int>(iter - _sn_vertex.begin());
+		}
+		if (Record._vertex.empty())
+		{
+			Record._block_reason = Vertex_Blocked;
+			return false;
+		}
+		return true;
+	}
+
+	bool VONEHeuristic::embed_links(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record, const bool Return_on_Block, VONELog::Logger& Log, 
+		int* Rank, const Embedding_Result* Speculation, const int Speculated_Rank)
+	{
+		VONESpectrum::Spectrum_Arena& SN_Spectrum = _spectrum;
+
+		//Edges embedding and Core Assignment, on the shortest paths weighted by the Path Distances, 
+		//    or on the cached candidate paths rank by rank until the core assignment succeeds:
+		VONETopo::LinkList VNLink;
+		Virtual_Network.get_edge(VNLink);
+		int VN_Bandwidth = VNLink[0]._edge_bandwidth;
+		int rank = 0;
+		for (; rank < max(_path_candidate_num, 1); rank++)
+		{
+			Record._edge.clear();
+			Record._core.clear();
+			if (_path_candidate_num == 0)
+				Edges_Embedding(VNLink, _sn_resource, SN_Spectrum, Record._vertex, Record._edge, Log);
+			else if (!Candidate_Edges_Embedding(VNLink, _substrate, _path_candidate->_path, static_cast<int>(_sn_vertex.size()), rank, 
+				SN_Spectrum, Record._vertex, Record._edge, Log) && rank > 0)
+				break;
+			if (Record._edge.empty())
+				break;
+
+			//The candidate paths of the ranks before the speculated one are the same as they were, and had no core left:
+			if (Speculation != NULL && rank < Speculated_Rank)
+				continue;
+			if (Speculation != NULL && rank == Speculated_Rank && Same_Paths(Record._edge, Speculation->_edge))
+			{
+				if (Speculation->_core.empty())
+					continue;
+				int width = (_hetergeneous_core != 0 && Request_Type(VN_Bandwidth) == 2) ? VN_Bandwidth / 2 : VN_Bandwidth;
+				if (Core_Assignment_Free(_substrate, Record._edge, Speculation->_core, Speculation->_start_frequency, width, SN_Spectrum))
 				{
-					if (_frequency_allocating_result[i - 1][j - 1][k - 1] == 0)
-					{
-						fragmentation += 1;
-					}
-					else if ((j != 2* HeterogeneousCoreIndex-1) && (j != 2* HeterogeneousCoreIndex) &&
-						((j % 2 == 0 ? j % (2 * CoreNumber) + 2 : (j + 1) % (2 * CoreNumber) + 1) != 2* HeterogeneousCoreIndex -1) &&
-						((j % 2 == 0 ? j % (2 * CoreNumber) + 2 : (j + 1) % (2 * CoreNumber) + 1) != 2 * HeterogeneousCoreIndex) &&
-						_frequency_allocating_result[i - 1][j - 1][k - 1] == 
-						_frequency_allocating_result[i - 1][(j%2==0 ? j%(2*CoreNumber)+2 : (j+1)%(2*CoreNumber)+1)- 1][k - 1])
+					Record._core = Speculation->_core;
+					Record._start_frequency = Speculation->_start_frequency;
+					break;
+				}
+			}
+
+			Core_Assignment(_substrate, Record._edge, _core_priority, _hetergeneous_core,
+				SN_Spectrum, _core_classification, _core_table, VN_Bandwidth,
+				Record._core, Record._start_frequency, _layout.get_core_num(), _core_scratch, Log);
+			if (!Record._core.empty())
+				break;
+		}
+		if (Rank != NULL)
+			*Rank = min(rank, max(_path_candidate_num, 1) - 1);
+		if (Record._edge.empty())
+		{
+			Record._block_reason = Edge_Blocked;
+			if (Return_on_Block)
+				return_computing(Virtual_Network, Record);
+			return false;
+		}
+		if (Record._core.empty())
+		{
+			Record._block_reason = Core_Blocked;
+			if (Return_on_Block)
+				return_computing(Virtual_Network, Record);
+			return false;
+		}
+		return true;
+	}
+
+	void VONEHeuristic::allocate_frequency(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record)
+	{
+		VONETopo::LinkList VNLink;
+		Virtual_Network.get_edge(VNLink);
+		int VN_Bandwidth = VNLink[0]._edge_bandwidth;
+
+		//Frequency Allocating:
+		Frequency_Allocating(_substrate, Record._edge, Record._core, 
+			Record._start_frequency, _hetergeneous_core, _layout, _spectrum, VN_Bandwidth, _undo);
+		Record._service_type = Request_Type(VN_Bandwidth);
+		Record._width = (_hetergeneous_core != 0 && Record._service_type == 2) ? VN_Bandwidth / 2 : VN_Bandwidth;
+	}
+
+	bool VONEHeuristic::repack(Allocation& Record)
+	{
+		VONESpectrum::Spectrum_Arena& SN_Spectrum = _spectrum;
+		const VONELayout::Core_Mask service_mask = _core_table._service_mask[Record._service_type];
+		int* hop = Record._resource.data() + 2 * Record._vertex_num;
+
+		//The starts free on an allowed core of every hop, the same as the path-wide availability in Core_Assignment:
+		vector<VONESpectrum::Spectrum_Word> path_mask, link_mask, core_mask;
+		path_mask.assign((SN_Spectrum.get_slot_num() + VONESpectrum::Word_Bits - 1) / VONESpectrum::Word_Bits, ~0ULL);
+		for (int h = 0; h < Record._hop_num; h++)
+		{
+			link_mask.assign(path_mask.size(), 0);
+			for (vector<int>::const_iterator citer = _core_table._priority.begin(); citer != _core_table._priority.end(); citer++)
+			{
+				if (service_mask & VONELayout::Core_Bit(*citer))
+				{
+					VONESpectrum::Spectrum_Bitmap occupancy = SN_Spectrum.occupancy(hop[2 * h], 2 * (*citer - 1) + hop[2 * h + 1] % 2);
+					if (occupancy.largest_free_run() < Record._width)
+						continue;
+					occupancy.run_start_mask(Record._width, core_mask);
+					VONESpectrum::Mask_Or(link_mask, core_mask);
+				}
+			}
+			VONESpectrum::Mask_And(path_mask, link_mask);
+		}
+
+		//The cores are picked hop by hop in priority order while the old frequency slots are still held, 
+		//    so the new ones never overlap them and the virtual network is carried at every moment:
+		vector<int> core_record(Record._hop_num);
+		VONESpectrum::Spectrum_Transaction pre_assignment;
+		int new_start = 0;
+		for (int start = VONESpectrum::Lowest_Slot(path_mask); start != 0 && start < Record._start_frequency; 
+			start = VONESpectrum::Lowest_Slot(path_mask, start + 1))
+		{
+			bool feasible = true;
+			for (int h = 0; h < Record._hop_num && feasible; h++)
+			{
+				feasible = false;
+				for (vector<int>::const_iterator citer = _core_table._priority.begin(); citer != _core_table._priority.end(); citer++)
+				{
+					if (!(service_mask & VONELayout::Core_Bit(*citer)))
+						continue;
+					int core_index = 2 * (*citer - 1) + hop[2 * h + 1] % 2;
+					VONESpectrum::Spectrum_Bitmap occupancy = SN_Spectrum.occupancy(hop[2 * h], core_index);
+					if (occupancy.is_free(start, Record._width))
 					{
-						crosstalk += 1;
+						pre_assignment.reserve(occupancy.unindexed(), start, Record._width);
+						core_record[h] = core_index;
+						feasible = true;
+						break;
 					}
-					else
-						continue;
 				}
-				tmp2.push_back(fragmentation);
 			}
-			_maximum_frequency_slot_index.push_back(tmp1);
-			_fragmetation.push_back(tmp2);
-			_crosstalk.push_back(crosstalk);
+			pre_assignment.rollback();
+			if (feasible)
+			{
+				new_start = start;
+				break;
+			}
+		}
+		if (new_start == 0)
+			return false;
+
+		//Make the new frequency slots, and then break the old ones:
+		for (int h = 0; h < Record._hop_num; h++)
+		{
+			SN_Spectrum.assign(hop[2 * h], core_record[h], new_start, Record._width, Record._service_type, 
+				_layout.crosstalk_mask(core_record[h] / 2 + 1, _hetergeneous_core));
+			SN_Spectrum.occupancy(hop[2 * h], core_record[h]).occupy(new_start, Record._width);
+			Update_End_Slot(SN_Spectrum, hop[2 * h], core_record[h], _undo);
+		}
+		for (int h = 0; h < Record._hop_num; h++)
+		{
+			SN_Spectrum.unassign(hop[2 * h], hop[2 * h + 1], Record._start_frequency, Record._width, 
+				_layout.crosstalk_mask(hop[2 * h + 1] / 2 + 1, _hetergeneous_core));
+			SN_Spectrum.occupancy(hop[2 * h], hop[2 * h + 1]).release(Record._start_frequency, Record._width);
+			Update_End_Slot(SN_Spectrum, hop[2 * h], hop[2 * h + 1], _undo);
+			hop[2 * h + 1] = core_record[h];
+		}
+		Record._start_frequency = new_start;
+		return true;
+	}
+
+	bool VONEHeuristic::swap_core(Allocation& Record, const int Hop, const int Core)
+	{
+		VONESpectrum::Spectrum_Arena& SN_Spectrum = _spectrum;
+		int* hop = Record._resource.data() + 2 * (Record._vertex_num + Hop);
+		int core_index = 2 * (Core - 1) + hop[1] % 2;
+		if (core_index == hop[1] || !(_core_table._service_mask[Record._service_type] & VONELayout::Core_Bit(Core)) || 
+			!SN_Spectrum.occupancy(hop[0], core_index).is_free(Record._start_frequency, Record._width))
+			return false;
+
+		//Make the new frequency slots, and then break the old ones:
+		SN_Spectrum.assign(hop[0], core_index, Record._start_frequency, Record._width, Record._service_type, 
+			_layout.crosstalk_mask(Core, _hetergeneous_core));
+		SN_Spectrum.occupancy(hop[0], core_index).occupy(Record._start_frequency, Record._width);
+		Update_End_Slot(SN_Spectrum, hop[0], core_index, _undo);
+		SN_Spectrum.unassign(hop[0], hop[1], Record._start_frequency, Record._width, 
+			_layout.crosstalk_mask(hop[1] / 2 + 1, _hetergeneous_core));
+		SN_Spectrum.occupancy(hop[0], hop[1]).release(Record._start_frequency, Record._width);
+		Update_End_Slot(SN_Spectrum, hop[0], hop[1], _undo);
+		hop[1] = core_index;
+		return true;
+	}
+
+	int VONEHeuristic::restore(const Allocation& Record)
+	{
+		const int* resource = Record._resource.data();
+		for (int v = 0; v < Record._vertex_num; v++, resource += 2)
+		{
+			_sn_vertex[_sn_position[resource[0]]]._remaining_computing_resource -= resource[1];
+		}
+
+		VONESpectrum::Spectrum_Arena& SN_Spectrum = _spectrum;
+		for (int h = 0; h < Record._hop_num; h++, resource += 2)
+		{
+			int core = resource[1] / 2 + 1;
+			SN_Spectrum.assign(resource[0], resource[1], Record._start_frequency, Record._width, Record._service_type, 
+				_layout.crosstalk_mask(core, _hetergeneous_core));
+			SN_Spectrum.occupancy(resource[0], resource[1]).occupy(Record._start_frequency, Record._width);
+			Update_End_Slot(SN_Spectrum, resource[0], resource[1], _undo);
+		}
+
+		int Handle = new_handle();
+		_allocation[Handle] = Record;
+		return Handle;
+	}
+
+	int VONEHeuristic::restore_ranked(const Allocation& Record)
+	{
+		sort(_sn_vertex.begin(), _sn_vertex.end(), SNUVcompare);
+		for (vector<Utilited_Vertex>::const_iterator iter = _sn_vertex.begin(); iter != _sn_vertex.end(); iter++)
+		{
+			_sn_position[_substrate.find_vertex(iter->_vertex._vertex_id)] = static_cast<int>(iter - _sn_vertex.begin());
+		}
+		return Record._vertex_num == 0 ? -1 : restore(Record);
+	}
+
+	long long VONEHeuristic::energy(const int Block_Num) const
+	{
+		//Each weight is above the largest value of all the terms after it:
+		long long max_weight = static_cast<long long>(_spectrum.get_link_num()) * _spectrum.get_slot_num() + 1;
+		return (Block_Num * (_spectrum.get_slot_num() + 1LL) + _spectrum.max_path_distance()) * max_weight + _spectrum.sum_path_distance();
+	}
+
+	int VONEHeuristic::new_handle()
+	{
+		int Handle;
+		if (_free_handle.empty())
+		{
+			Handle = static_cast<int>(_allocation.size());
+			_allocation.push_back(Allocation());
+		}
+		else
+		{
+			Handle = _free_handle.back();
+			_free_handle.pop_back();
+		}
+		return Handle;
+	}
+
+	void VONEHeuristic::return_computing(const VONETopo::Topo& Virtual_Network, const Embedding_Result& Record)
+	{
+		VONETopo::NodeList VNNode;
+		Virtual_Network.get_vertex(VNNode);
+		for (VONETopo::NodeListIT iter = VNNode.begin(); iter != VNNode.end(); iter++)
+		{
+			int position = _sn_position[_substrate.find_vertex(Record._vertex[iter->_vertex_id - 1])];
+			_sn_vertex[position]._remaining_computing_resource += iter->_vertex_computing_capacity;
+		}
+	}
+
+	void VONEHeuristic::pack(const VONETopo::Topo& Virtual_Network, const Embedding_Result& Record, Allocation& Packed) const
+	{
+		VONETopo::NodeList VNNode;
+		Virtual_Network.get_vertex(VNNode);
+		Packed._vertex_num = static_cast<int>(VNNode.size());
+		Packed._hop_num = static_cast<int>(Record._core.size());
+		Packed._start_frequency = Record._start_frequency;
+		Packed._width = Record._width;
+		Packed._service_type = Record._service_type;
+		Packed._resource.clear();
+		Packed._resource.reserve(2 * (Packed._vertex_num + Packed._hop_num));
+		for (VONETopo::NodeListIT iter = VNNode.begin(); iter != VNNode.end(); iter++)
+		{
+			Packed._resource.push_back(_substrate.find_vertex(Record._vertex[iter->_vertex_id - 1]));
+			Packed._resource.push_back(iter->_vertex_computing_capacity);
+		}
+
+		int index = 1;
+		for (vector<vector<int> >::const_iterator liter = Record._edge.begin(); liter != Record._edge.end(); liter++)
+		{
+			for (vector<int>::const_iterator siter = liter->begin() + 1; siter != prev(liter->end()); siter++)
+			{
+				Packed._resource.push_back(_substrate.find_edge(*prev(siter), *siter));
+				Packed._resource.push_back(Record._core[index - 1]);
+				index++;
+			}
+		}
+	}
+
+	const VONESpectrum::Spectrum_Arena& VONEHeuristic::get_spectrum() const
+	{
+		return _spectrum;
+	}
+
+	ostream& operator <<(ostream& outs, const Embedding_Result& Result)
+	{
+		switch (Result._block_reason)
+		{
+		case Vertex_Blocked:
+			outs << "Due to the Vertex computing capacity limit, current Virtual Network will be blocked!\n";
+			return outs;
+		case Edge_Blocked:
+			outs << "Due to the Edge frequency capacity limit, current Virtual Network will be blocked!\n";
+			return outs;
+		case Core_Blocked:
+			outs << "Due to the Core Assignment limit, current Virtual Network will be blocked!\n";
+			return outs;
+		default:
+			break;
+		}
+
+		outs << "Virtual Network " << Result._handle << " has been embedded:\n";
+		for (vector<int>::const_iterator iter = Result._vertex.begin(); iter != Result._vertex.end(); iter++)
+		{
+			outs << "No." << iter - Result._vertex.begin() + 1 << " Node in VN was embedded in SN Node No." << *iter << "\n";
+		}
+		int index = 1;
+		for (vector<vector<int> >::const_iterator liter = Result._edge.begin(); liter != Result._edge.end(); liter++)
+		{
+			outs << "No." << liter - Result._edge.begin() + 1 << " Link in VN was embedded in SN Link ";
+			for (vector<int>::const_iterator siter = liter->begin(); siter != prev(liter->end()); siter++)
+			{
+				if (siter != liter->begin())
+				{
+					outs << "(Core " << Result._core[index - 1] / 2 + 1 << ")->";
+					index++;
+				}
+				outs << *siter;
+			}
+			outs << "\n";
 		}
+		outs << "with start frequency: " << Result._start_frequency << " and " << Result._width << " frequency slots\n";
 
-		fout.close();
+		return outs;
 	}
 
 	ostream& operator <<(ostream& outs, const VONEHeuristic& VONEHeuristic)
@@ -298,9 +1478,9 @@ namespace VONEHeuristic
 			{
 				for (unsigned int j = 1; j <= VONEHeuristic._vertex_embedding_result[i - 1].size(); j++)
 				{
-					outs << "The node " << j << " in VN " << i << " is embedded in SN " << VONEHeuristic._vertex_embedding_result[i - 1][j - 1] << endl;
+					outs << "The node " << j << " in VN " << i << " is embedded in SN " << VONEHeuristic._vertex_embedding_result[i - 1][j - 1] << "\n";
 				}
-				outs << endl;
+				outs << "\n";
 			}
 			else
 				outs << "Sorted Virtual Network " << i << " will be blocked!\n\n";
@@ -323,9 +1503,9 @@ namespace VONEHeuristic
 						outs << VONEHeuristic._edge_embedding_result[i - 1][j - 1][k - 1] << "->";
 					}
 					outs << VONEHeuristic._edge_embedding_result[i - 1][j - 1][k - 1] << ", with the cost: " 
-						<< VONEHeuristic._edge_embedding_result[i - 1][j - 1][k] << endl;
+						<< VONEHeuristic._edge_embedding_result[i - 1][j - 1][k] << "\n";
 				}
-				outs << endl;
+				outs << "\n";
 			}
 			else
 				outs << "Sorted Virtual Network " << i << " will be blocked!\n\n";
@@ -344,9 +1524,9 @@ namespace VONEHeuristic
 					if (j != VONEHeuristic._core_assignment_result[i - 1].size())
 						outs << VONEHeuristic._core_assignment_result[i - 1][j - 1] / 2 + 1 << "-";
 					else
-						outs << VONEHeuristic._core_assignment_result[i - 1][j - 1] / 2 + 1 << endl;
+						outs << VONEHeuristic._core_assignment_result[i - 1][j - 1] / 2 + 1 << "\n";
 				}
-				outs << endl;
+				outs << "\n";
 			}
 			else
 				outs << "Sorted Virtual Network " << i << " will be blocked!\n\n";
@@ -359,132 +1539,326 @@ namespace VONEHeuristic
 		{
 			if (VONEHeuristic._start_frequency_result[i - 1] != 0)
 			{
-				outs << "The Start Frequency in VN " << i << " is: " << VONEHeuristic._start_frequency_result[i - 1] << endl;
-				outs << endl;
+				outs << "The Start Frequency in VN " << i << " is: " << VONEHeuristic._start_frequency_result[i - 1] << "\n";
+				outs << "\n";
 			}
 			else
 				outs << "Sorted Virtual Network " << i << " will be blocked!\n\n";
 		}
 		outs << "------------------------------------------\n\n";
 
-		//Output the frequency allocating in all substrate edges:
-		outs << "----------Frequency Allocating Result----------\n\n";
-		for (unsigned int i = 1; i <= VONEHeuristic._frequency_allocating_result.size(); i++)
+		//Output the frequency allocating in all substrate edges, which is as large as the spectrum itself:
+		const VONESpectrum::Spectrum_Arena& SN_Spectrum = VONEHeuristic._spectrum;
+		if (VONEHeuristic._spectrum_dump)
 		{
-			outs << "The Frequency Allocating of the smaller source to bigger destination in No." << i << " edge is following: \n";
-			for (unsigned int j = 1; j <= VONEHeuristic._frequency_allocating_result[i - 1].size(); j = j + 2)
+			outs << "----------Frequency Allocating Result----------\n\n";
+			for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
 			{
-				for (unsigned int k = 1; k <= VONEHeuristic._frequency_allocating_result[i - 1][j - 1].size(); k++)
+				outs << "The Frequency Allocating of the smaller source to bigger destination in No." << i << " edge is following: \n";
+				for (int j = 1; j <= 2 * SN_Spectrum.get_core_num(); j = j + 2)
 				{
-					outs << VONEHeuristic._frequency_allocating_result[i - 1][j - 1][k - 1] << "\t";
+					const signed char* service_type = SN_Spectrum.service_type(i - 1, j - 1);
+					for (int k = 1; k <= SN_Spectrum.get_slot_num(); k++)
+					{
+						outs << static_cast<int>(service_type[k - 1]) << "\t";
+					}
+					outs << "\n";
 				}
-				outs << endl;
-			}
-			outs << endl;
+				outs << "\n";
 
-			outs << "The Frequency Allocating of the bigger source to smaller destination in No." << i << " edge is following: \n";
-			for (unsigned int j = 2; j <= VONEHeuristic._frequency_allocating_result[i - 1].size(); j = j + 2)
-			{
-				for (unsigned int k = 1; k <= VONEHeuristic._frequency_allocating_result[i - 1][j - 1].size(); k++)
+				outs << "The Frequency Allocating of the bigger source to smaller destination in No." << i << " edge is following: \n";
+				for (int j = 2; j <= 2 * SN_Spectrum.get_core_num(); j = j + 2)
 				{
-					outs << VONEHeuristic._frequency_allocating_result[i - 1][j - 1][k - 1] << "\t";
+					const signed char* service_type = SN_Spectrum.service_type(i - 1, j - 1);
+					for (int k = 1; k <= SN_Spectrum.get_slot_num(); k++)
+					{
+						outs << static_cast<int>(service_type[k - 1]) << "\t";
+					}
+					outs << "\n";
 				}
-				outs << endl;
+				outs << "\n";
 			}
-			outs << endl;
+			outs << "-----------------------------------------------\n\n";
 		}
-		outs << "-----------------------------------------------\n\n";
 		
 
 		//Output the maximum frequency slot index:
 		outs << "----------Maximum Frequency Slot Index----------\n\n";
 		outs << "The Maximum Frequency Slot Index of the smaller source to bigger destination is following: \n";
-		for (unsigned int j = 1; j <= VONEHeuristic._maximum_frequency_slot_index[0].size(); j = j + 2)
+		for (int j = 1; j <= 2 * SN_Spectrum.get_core_num(); j = j + 2)
 		{
-			for (unsigned int i = 1; i <= VONEHeuristic._maximum_frequency_slot_index.size(); i++)
+			for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
 			{
-				outs << VONEHeuristic._maximum_frequency_slot_index[i - 1][j - 1] << "\t";
+				outs << SN_Spectrum.highest_used_slot(i - 1, j - 1) << "\t";
 			}
-			outs << endl;
+			outs << "\n";
 		}
-		outs << endl;
+		outs << "\n";
 
 		outs << "The Maximum Frequency Slot Index of the bigger source to smaller destination is following: \n";
-		for (unsigned int j = 2; j <= VONEHeuristic._maximum_frequency_slot_index[0].size(); j = j + 2)
+		for (int j = 2; j <= 2 * SN_Spectrum.get_core_num(); j = j + 2)
 		{
-			for (unsigned int i = 1; i <= VONEHeuristic._maximum_frequency_slot_index.size(); i++)
+			for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
 			{
-				outs << VONEHeuristic._maximum_frequency_slot_index[i - 1][j - 1] << "\t";
+				outs << SN_Spectrum.highest_used_slot(i - 1, j - 1) << "\t";
 			}
-			outs << endl;
+			outs << "\n";
 		}
 		outs << "\n------------------------------------------------\n\n";
 
 		//Output the fragmentation:
 		outs << "----------Fragmetation----------\n\n";
 		outs << "The Fragmetation of the smaller source to bigger destination is following: \n";
-		for (unsigned int j = 1; j <= VONEHeuristic._fragmetation[0].size(); j = j + 2)
+		for (int j = 1; j <= 2 * SN_Spectrum.get_core_num(); j = j + 2)
+		{
+			for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
+			{
+				outs << SN_Spectrum.fragmentation(i - 1, j - 1) << "\t";
+			}
+			outs << "\n";
+		}
+		outs << "\n";
+
+		outs << "The Fragmetation of the bigger source to smaller destination is following: \n";
+		for (int j = 2; j <= 2 * SN_Spectrum.get_core_num(); j = j + 2)
+		{
+			for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
+			{
+				outs << SN_Spectrum.fragmentation(i - 1, j - 1) << "\t";
+			}
+			outs << "\n";
+		}
+		outs << "\n--------------------------------\n\n";
+
+		//Output the crosstalk:
+		outs << "----------Crosstalk----------\n\n";
+		outs << "The Crosstalk is following: \n";
+		for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
+		{
+			outs << SN_Spectrum.crosstalk(i - 1) << "\t";
+		}
+		outs << "\n\n-----------------------------\n\n";
+
+		//Output the block number:
+		outs << "----------Block Result----------\n\n";
+		outs << "There are " << VONEHeuristic._block_num << " requests will be blocked!\n\n";
+		outs << "--------------------------------\n\n";
+
+		return outs;
+	}
+
+	VONEHeuristic::~VONEHeuristic()
+	{
+
+	}
+}
+
+namespace
+{
+	Crosstalk_Policy Parse_Crosstalk(const string& CrosstalkYesorNo)
+	{
+		if ((CrosstalkYesorNo == "Yes") || (CrosstalkYesorNo == "yes"))
+			return Crosstalk_Allowed;
+		else if ((CrosstalkYesorNo == "No") || (CrosstalkYesorNo == "no"))
+			return Crosstalk_Avoided;
+		else
+			return Crosstalk_Unspecified;
+	}
+
+	void Core_Table_Define(VONEHeuristic::Core_Table& Table, const vector<int>& Core_Priority, vector<int>& Core_Classification, const int Hetergeneous_Core)
+	{
+		if (Hetergeneous_Core != 0)
+		{
+			Core_Classification[Hetergeneous_Core - 1] = 2;
+			for (vector<int>::iterator iter = Core_Classification.begin(); iter != Core_Classification.end(); iter++)
+			{
+				if (*iter == 0)
+					*iter = -1;
+			}
+		}
+
+		Table._priority = Core_Priority;
+		Table._service_mask.fill(0);
+		for (vector<int>::const_iterator iter = Core_Classification.begin(); iter != Core_Classification.end(); iter++)
+		{
+			VONELayout::Core_Mask core = VONELayout::Core_Bit(static_cast<int>(iter - Core_Classification.begin() + 1));
+			for (int Service_Type = 1; Service_Type <= 3; Service_Type++)
+			{
+				//An unclassified core carries any service type, but only type 1 and 3 with a hetergeneous core:
+				if (*iter == Service_Type || *iter == 0 || (*iter == -1 && Service_Type != 2))
+					Table._service_mask[Service_Type] |= core;
+			}
+		}
+	}
+
+	bool VNcompare(const VONETopo::Topo& VNA, const VONETopo::Topo& VNB)
+	{
+		if (VNA.get_vertex_num() > VNB.get_vertex_num())
+			return true;
+		else if ((VNA.get_vertex_num() == VNB.get_vertex_num()) &&
+			(VNA.get_edge_num() > VNB.get_edge_num()))
+			return true;
+		else
+			return false;
+	}
+
+	void Order_Virtual_Networks(const vector<VONETopo::Topo>& Virtual_Network_List, const int Start, const unsigned int Seed, vector<int>& Order)
+	{
+		int VN_Num = static_cast<int>(Virtual_Network_List.size());
+		Order.resize(VN_Num);
+		iota(Order.begin(), Order.end(), 0);
+		if (Start == 0)
 		{
-			for (unsigned int i = 1; i <= VONEHeuristic._fragmetation.size(); i++)
-			{
-				outs << VONEHeuristic._fragmetation[i - 1][j - 1] << "\t";
-			}
-			outs << endl;
+			sort(Order.begin(), Order.end(), [&](const int A, const int B) { return VNcompare(Virtual_Network_List[A], Virtual_Network_List[B]); });
+			return;
 		}
-		outs << endl;
 
-		outs << "The Fragmetation of the bigger source to smaller destination is following: \n";
-		for (unsigned int j = 2; j <= VONEHeuristic._fragmetation[0].size(); j = j + 2)
+		//The ties are broken by the shuffle, which the stable sort keeps:
+		mt19937 Generator(Seed + Start);
+		shuffle(Order.begin(), Order.end(), Generator);
+		vector<long long> Key(VN_Num, 0);
+		for (int i = 0; i < VN_Num; i++)
 		{
-			for (unsigned int i = 1; i <= VONEHeuristic._fragmetation.size(); i++)
+			const VONETopo::Topo& VN = Virtual_Network_List[i];
+			VONETopo::NodeList VNNode;
+			VONETopo::LinkList VNLink;
+			switch (Start % 4)
 			{
-				outs << VONEHeuristic._fragmetation[i - 1][j - 1] << "\t";
+			case 1:		//The size, the same as VNcompare
+				Key[i] = static_cast<long long>(VN.get_vertex_num()) * (INT_MAX / 2) + VN.get_edge_num();
+				break;
+			case 2:		//The frequency slots demanded by all links
+				VN.get_edge(VNLink);
+				for (VONETopo::LinkListIT iter = VNLink.begin(); iter != VNLink.end(); iter++)
+					Key[i] += iter->_edge_bandwidth;
+				break;
+			case 3:		//The computing resource demanded by all nodes
+				VN.get_vertex(VNNode);
+				for (VONETopo::NodeListIT iter = VNNode.begin(); iter != VNNode.end(); iter++)
+					Key[i] += iter->_vertex_computing_capacity;
+				break;
+			default:	//The random ordering
+				break;
 			}
-			outs << endl;
 		}
-		outs << "\n--------------------------------\n\n";
+		stable_sort(Order.begin(), Order.end(), [&](const int A, const int B) { return Key[A] > Key[B]; });
+	}
 
-		//Output the crosstalk:
-		outs << "----------Crosstalk----------\n\n";
-		outs << "The Crosstalk is following: \n";
-		for (unsigned int i = 1; i <= VONEHeuristic._crosstalk.size(); i++)
+	int Max_Slot_Index(const VONESpectrum::Spectrum_Arena& SN_Spectrum)
+	{
+		int max_slot = 0;
+		for (int link = 0; link < SN_Spectrum.get_link_num(); link++)
 		{
-			outs << VONEHeuristic._crosstalk[i - 1] << "\t";
+			for (int core_index = 0; core_index < 2 * SN_Spectrum.get_core_num(); core_index++)
+				max_slot = max(max_slot, SN_Spectrum.highest_used_slot(link, core_index));
 		}
-		outs << "\n\n-----------------------------\n\n";
+		return max_slot;
+	}
 
-		//Output the block number:
-		outs << "----------Block Result----------\n\n";
-		outs << "There are " << VONEHeuristic._block_num << " requests will be blocked!\n\n";
-		outs << "--------------------------------\n\n";
+	Shared_Substrate::Shared_Substrate(const VONETopo::Topo& Substrate_Network, const VONESpectrum::Spectrum_Arena& SN_Spectrum, const int Request_Num) : 
+		_word_num((SN_Spectrum.get_slot_num() + VONESpectrum::Word_Bits - 1) / VONESpectrum::Word_Bits), _core_num(SN_Spectrum.get_core_num()), 
+		_word(static_cast<size_t>(SN_Spectrum.get_link_num()) * 2 * SN_Spectrum.get_core_num() * _word_num), 
+		_computing(Substrate_Network.get_vertex_num()), _commit_log(Request_Num), _commit_request(Request_Num), 
+		_commit_owner(Request_Num), _commit_num(0)
+	{
+		for (vector<atomic<VONESpectrum::Spectrum_Word> >::iterator iter = _word.begin(); iter != _word.end(); iter++)
+			iter->store(0, memory_order_relaxed);
 
-		return outs;
+		VONETopo::NodeList SN_Vertex;
+		Substrate_Network.get_vertex(SN_Vertex);
+		for (VONETopo::NodeListIT iter = SN_Vertex.begin(); iter != SN_Vertex.end(); iter++)
+			_computing[iter - SN_Vertex.begin()].store(iter->_vertex_computing_capacity, memory_order_relaxed);
+
+		for (vector<atomic<int> >::iterator iter = _commit_owner.begin(); iter != _commit_owner.end(); iter++)
+			iter->store(-1, memory_order_relaxed);
 	}
 
-	VONEHeuristic::~VONEHeuristic()
+	VONESpectrum::Spectrum_Word Slot_Word_Mask(const int Word, const int Start, const int Width)
 	{
-
+		int low = max(Start - 1, Word * VONESpectrum::Word_Bits) - Word * VONESpectrum::Word_Bits;
+		int high = min(Start + Width - 2, (Word + 1) * VONESpectrum::Word_Bits - 1) - Word * VONESpectrum::Word_Bits;
+		VONESpectrum::Spectrum_Word mask = (high == VONESpectrum::Word_Bits - 1) ? ~0ULL : ((1ULL << (high + 1)) - 1);
+		return mask & ~((1ULL << low) - 1);
 	}
-}
 
-namespace
-{
-	bool VNcompare(const VONETopo::Topo& VNA, const VONETopo::Topo& VNB)
+	bool Reserve_Allocation(Shared_Substrate& Shared, const VONEHeuristic::Allocation& Record)
 	{
-		VONETopo::NodeList VNAVertex, VNBVertex;
-		VONETopo::LinkList VNAEdge, VNBEdge;
-		VNA.get_vertex(VNAVertex);
-		VNB.get_vertex(VNBVertex);
-		VNA.get_edge(VNAEdge);
-		VNB.get_edge(VNBEdge);
+		//The computing resource, which is given back as soon as a node falls short:
+		const int* resource = Record._resource.data();
+		int vertex = 0;
+		for (; vertex < Record._vertex_num; vertex++)
+		{
+			int cpu = resource[2 * vertex + 1];
+			if (Shared._computing[resource[2 * vertex]].fetch_sub(cpu, memory_order_acq_rel) < cpu)
+			{
+				Shared._computing[resource[2 * vertex]].fetch_add(cpu, memory_order_acq_rel);
+				break;
+			}
+		}
 
-		if (VNAVertex.size() > VNBVertex.size())
-			return true;
-		else if ((VNAVertex.size() == VNBVertex.size()) &&
-			(VNAEdge.size() > VNBEdge.size()))
+		//The frequency slots word by word, where a word changed by another thread is tried again 
+		//    unless the change has taken one of the slots:
+		const int* hop = resource + 2 * Record._vertex_num;
+		int first_word = (Record._start_frequency - 1) / VONESpectrum::Word_Bits;
+		int last_word = (Record._start_frequency + Record._width - 2) / VONESpectrum::Word_Bits;
+		int taken_hop = 0, taken_word = first_word;
+		bool conflict = (vertex < Record._vertex_num);
+		for (; taken_hop < Record._hop_num && !conflict; taken_hop++)
+		{
+			atomic<VONESpectrum::Spectrum_Word>* word = Shared._word.data() + 
+				(static_cast<size_t>(hop[2 * taken_hop]) * 2 * Shared._core_num + hop[2 * taken_hop + 1]) * Shared._word_num;
+			for (taken_word = first_word; taken_word <= last_word; taken_word++)
+			{
+				VONESpectrum::Spectrum_Word mask = Slot_Word_Mask(taken_word, Record._start_frequency, Record._width);
+				VONESpectrum::Spectrum_Word expected = word[taken_word].load(memory_order_relaxed);
+				do
+				{
+					if (expected & mask)
+					{
+						conflict = true;
+						break;
+					}
+				} while (!word[taken_word].compare_exchange_weak(expected, expected | mask, memory_order_acq_rel, memory_order_relaxed));
+				if (conflict)
+					break;
+			}
+		}
+		if (!conflict)
 			return true;
-		else
-			return false;
+		VONE_PROFILE_COUNT(VONEProfile::Counter_Rollback, 1);
+
+		//Give back the words of the hops taken in full and of the hop where the conflict was found, and then the computing resource:
+		if (vertex == Record._vertex_num)
+		{
+			taken_hop--;
+			for (int h = 0; h <= taken_hop; h++)
+			{
+				atomic<VONESpectrum::Spectrum_Word>* word = Shared._word.data() + 
+					(static_cast<size_t>(hop[2 * h]) * 2 * Shared._core_num + hop[2 * h + 1]) * Shared._word_num;
+				for (int w = first_word; w <= (h < taken_hop ? last_word : taken_word - 1); w++)
+					word[w].fetch_and(~Slot_Word_Mask(w, Record._start_frequency, Record._width), memory_order_acq_rel);
+			}
+		}
+		for (int v = 0; v < vertex; v++)
+			Shared._computing[resource[2 * v]].fetch_add(resource[2 * v + 1], memory_order_acq_rel);
+		return false;
+	}
+
+	void Return_Allocation(Shared_Substrate& Shared, const VONEHeuristic::Allocation& Record)
+	{
+		const int* resource = Record._resource.data();
+		const int* hop = resource + 2 * Record._vertex_num;
+		int first_word = (Record._start_frequency - 1) / VONESpectrum::Word_Bits;
+		int last_word = (Record._start_frequency + Record._width - 2) / VONESpectrum::Word_Bits;
+		for (int h = 0; h < Record._hop_num; h++)
+		{
+			atomic<VONESpectrum::Spectrum_Word>* word = Shared._word.data() + 
+				(static_cast<size_t>(hop[2 * h]) * 2 * Shared._core_num + hop[2 * h + 1]) * Shared._word_num;
+			for (int w = first_word; w <= last_word; w++)
+				word[w].fetch_and(~Slot_Word_Mask(w, Record._start_frequency, Record._width), memory_order_acq_rel);
+		}
+		for (int v = 0; v < Record._vertex_num; v++)
+			Shared._computing[resource[2 * v]].fetch_add(resource[2 * v + 1], memory_order_acq_rel);
 	}
 
 	bool VNVcompare(const VONETopo::Vertex& VA, const VONETopo::Vertex& VB)
@@ -515,23 +1889,17 @@ namespace
 		}
 	}
 
-	int Core_Distance(const int Core1_index, const int Core2_index, const int C)
-	{
-		int distance = abs(Core1_index - Core2_index);
-
-		return distance > C / 2 ? C - distance : distance;
-	}
-
-	int Nearest_Core_with_Same_Cost(const vector<int>& Core_Cost, const vector<int>::iterator& Initial_index, const int Last_Priority_Core, const int CoreNumber)
+	int Nearest_Core_with_Same_Cost(const vector<int>& Core_Cost, const vector<int>::iterator& Initial_index, const int Last_Priority_Core, 
+		const VONELayout::Core_Layout& Layout)
 	{
 		int priority_index = static_cast<int>(Initial_index - Core_Cost.begin() + 1);
-		int distance = Core_Distance(priority_index, Last_Priority_Core, CoreNumber);
+		int distance = Layout.distance(priority_index, Last_Priority_Core);
 		for (vector<int>::const_iterator Citer = Core_Cost.begin(); Citer != Core_Cost.end(); Citer++)
 		{
 			int priority_index_tmp = static_cast<int>(Citer - Core_Cost.begin() + 1);
 			if (*Citer == *Initial_index)
 			{
-				int distance_tmp = Core_Distance(priority_index_tmp, Last_Priority_Core, CoreNumber);
+				int distance_tmp = Layout.distance(priority_index_tmp, Last_Priority_Core);
 				if (distance_tmp < distance)
 				{
 					priority_index = priority_index_tmp;
@@ -542,10 +1910,10 @@ namespace
 		return priority_index;
 	}
 
-	void Core_Priority_Define(vector<int>& Core_Priority, const int Hetergeneous_Core, const int CoreNumber, ofstream& outs)
+	void Core_Priority_Define(vector<int>& Core_Priority, const int Hetergeneous_Core, const VONELayout::Core_Layout& Layout, VONELog::Logger& Log)
 	{
-		vector<int> Core_Cost(CoreNumber);
-		outs << "Core priority is: ";
+		vector<int> Core_Cost(Layout.get_core_num());
+		VONE_LOG(Log, VONELog::Log_Info) << "Core priority is: ";
 		for (vector<int>::iterator iter = Core_Priority.begin(); iter != Core_Priority.end(); iter++)
 		{
 			int priority_index = 0;
@@ -563,144 +1931,74 @@ namespace
 				if (zeroexist == Core_Cost.end())
 				{
 					vector<int>::iterator Min_Cost_index = min_element(Core_Cost.begin(), Core_Cost.end());
-					priority_index = Nearest_Core_with_Same_Cost(Core_Cost, Min_Cost_index, *prev(iter), CoreNumber);
+					priority_index = Nearest_Core_with_Same_Cost(Core_Cost, Min_Cost_index, *prev(iter), Layout);
 				}
 				else
 				{
-					priority_index = Nearest_Core_with_Same_Cost(Core_Cost, zeroexist, *prev(iter), CoreNumber);
+					priority_index = Nearest_Core_with_Same_Cost(Core_Cost, zeroexist, *prev(iter), Layout);
 				}
 			}
 
 			*iter = priority_index;
-			if (*iter == Hetergeneous_Core)
-			{
-				Core_Cost[(*iter + CoreNumber) % CoreNumber + 1 - 1]--;
-				Core_Cost[(*iter + CoreNumber - 2) % CoreNumber + 1 - 1]--;
-			}
-			else
+			for (VONELayout::Core_Mask mask = Layout.neighbour_mask(*iter); mask != 0; mask &= mask - 1)
 			{
-				Core_Cost[(*iter + CoreNumber) % CoreNumber + 1 - 1]++;
-				Core_Cost[(*iter + CoreNumber - 2) % CoreNumber + 1 - 1]++;
+				if (*iter == Hetergeneous_Core)
+					Core_Cost[VONELayout::Lowest_Core(mask) - 1]--;
+				else
+					Core_Cost[VONELayout::Lowest_Core(mask) - 1]++;
 			}
 			Core_Cost[*iter - 1] = INT_MAX / 2; //Notice the INT_MAX may cause overflow, here just choose a big value instead of infinity
 
 			//Print the Core Priority:
-			if (iter == prev(Core_Priority.end()))
-				outs << *iter << endl;
-			else
-				outs << *iter << "->";
+			VONE_LOG(Log, VONELog::Log_Info) << *iter << (iter == prev(Core_Priority.end()) ? "\n" : "->");
 		}
 	}
 
-	void Core_Classification_Define(vector<int>& Core_Classification, const vector<int> Core_Priority, const vector<int> Service_Type, const int CoreNumber, ofstream& outs)
+	void Core_Classification_Define(vector<int>& Core_Classification, const vector<int>& Core_Priority, const vector<int>& Service_Type, 
+		const VONELayout::Core_Layout& Layout, VONELog::Logger& Log)
 	{
 		int Type_Num = static_cast<int>(Service_Type.size());
 		int Sindex = 0;
 		for (vector<int>::const_iterator iter = Core_Priority.begin(); iter != Core_Priority.end(); iter++)
 		{
-			int frontcore = (*iter + CoreNumber) % CoreNumber + 1;
-			int backcore = (*iter + CoreNumber - 2) % CoreNumber + 1;
+			//For Hetergeneous, the core of the first priority is the hetergeneous core:
+			if (Type_Num == 2 && iter == Core_Priority.begin())
+			{
+				Core_Classification[*iter - 1] = 2;
+				continue;
+			}
 
-			//For Homogeneous:
-			if (Type_Num == 3)
+			//The service type is skipped when an adjacent core has taken it, at most twice:
+			bool assigned = false;
+			for (int attempt = 1; attempt <= 2 && !assigned; attempt++)
 			{
-				if (Core_Classification[frontcore - 1] != Service_Type[Sindex % Type_Num])
+				bool adjacent_flag = false;
+				for (VONELayout::Core_Mask mask = Layout.neighbour_mask(*iter); mask != 0; mask &= mask - 1)
 				{
-					if (Core_Classification[backcore - 1] != Service_Type[Sindex % Type_Num])
-					{
-						Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-						Sindex++;
-						continue;
-					}
-					else
+					if (Core_Classification[VONELayout::Lowest_Core(mask) - 1] == Service_Type[Sindex % Type_Num])
 					{
-						Sindex++;
-						if (Core_Classification[frontcore - 1] != Service_Type[Sindex % Type_Num])
-						{
-							Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-							Sindex++;
-							continue;
-						}
-						else
-						{
-							Sindex++;
-							Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-							Sindex++;
-							continue;
-						}
+						adjacent_flag = true;
+						break;
 					}
 				}
-				else
+
+				if (adjacent_flag == false)
 				{
-					Sindex++;
-					if (Core_Classification[backcore - 1] != Service_Type[Sindex % Type_Num])
-					{
-						Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-						Sindex++;
-						continue;
-					}
-					else
-					{
-						Sindex++;
-						Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-						Sindex++;
-						continue;
-					}
+					Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
+					assigned = true;
 				}
+				Sindex++;
 			}
-
-			//For Hetergeneous:
-			if (Type_Num == 2)
+			if (assigned == false)
 			{
-				if (iter == Core_Priority.begin())
+				//For Homogeneous, the third service type is taken anyway, and for Hetergeneous, the core serves as the hetergeneous core:
+				if (Type_Num == 3)
 				{
-					Core_Classification[*iter - 1] = 2;
-					continue;
+					Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
+					Sindex++;
 				}
 				else
-				{
-					if (Core_Classification[frontcore - 1] != Service_Type[Sindex % Type_Num])
-					{
-						if (Core_Classification[backcore - 1] != Service_Type[Sindex % Type_Num])
-						{
-							Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-							Sindex++;
-							continue;
-						}
-						else
-						{
-							Sindex++;
-							if (Core_Classification[frontcore - 1] != Service_Type[Sindex % Type_Num])
-							{
-								Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-								Sindex++;
-								continue;
-							}
-							else
-							{
-								Core_Classification[*iter - 1] = 2;
-								Sindex++;
-								continue;
-							}
-						}
-					}
-					else
-					{
-						Sindex++;
-						if (Core_Classification[backcore - 1] != Service_Type[Sindex % Type_Num])
-						{
-							Core_Classification[*iter - 1] = Service_Type[Sindex % Type_Num];
-							Sindex++;
-							continue;
-						}
-						else
-						{
-							Core_Classification[*iter - 1] = 2;
-							Sindex++;
-							continue;
-						}
-					}
-				}
+					Core_Classification[*iter - 1] = 2;
 			}
 		}
 
@@ -731,17 +2029,22 @@ namespace
 			}
 		}
 
-		outs << "Core classification is: ";
-		for (vector<int>::iterator iter = Core_Classification.begin(); iter != prev(Core_Classification.end()); iter++)
+		if (VONE_LOG_ON(Log, VONELog::Log_Info))
 		{
-			outs << *iter << "->";
+			ostream& outs = Log.stream();
+			outs << "Core classification is: ";
+			for (vector<int>::iterator iter = Core_Classification.begin(); iter != prev(Core_Classification.end()); iter++)
+			{
+				outs << *iter << "->";
+			}
+			outs << *prev(Core_Classification.end()) << endl;
 		}
-		outs << *prev(Core_Classification.end()) << endl;
 	}
 
 	void Vertexes_Embedding(VONETopo::NodeList& Virtual_Network_NodeList, vector<VONEHeuristic::Utilited_Vertex>& SN_Utilited_Vertex,
-		vector<int>& vertex_embedding_result, ofstream& outs)
+		vector<int>& vertex_embedding_result, const bool Return_on_Block, VONELog::Logger& Log)
 	{
+		VONE_PROFILE_SCOPE(VONEProfile::Phase_Vertexes_Embedding);
 		vertex_embedding_result.resize(Virtual_Network_NodeList.size());
 		sort(Virtual_Network_NodeList.begin(), Virtual_Network_NodeList.end(), VNVcompare);
 		sort(SN_Utilited_Vertex.begin(), SN_Utilited_Vertex.end(), SNUVcompare);
@@ -757,100 +2060,131 @@ namespace
 			}
 			else
 			{
+				if (Return_on_Block)
+				{
+					for (VONETopo::NodeListIT riter = Virtual_Network_NodeList.begin(); riter != viter; riter++)
+						SN_Utilited_Vertex[riter - Virtual_Network_NodeList.begin()]._remaining_computing_resource += riter->_vertex_computing_capacity;
+				}
 				vertex_embedding_result.clear();
-				outs << "Due to the Vertex computing capacity limit, current Virtual Network will be blocked!\n";
+				VONE_LOG(Log, VONELog::Log_Info) << "Due to the Vertex computing capacity limit, current Virtual Network will be blocked!\n";
 				break;
 			}
 		}
-		outs << "Current virtual network vertexes embedding result is: \n";
-		for (vector<int>::const_iterator iter = vertex_embedding_result.begin(); iter != vertex_embedding_result.end(); iter++)
+		if (VONE_LOG_ON(Log, VONELog::Log_Debug))
 		{
-			outs << "No." << iter - vertex_embedding_result.begin() + 1 << " Node in VN was embedded in SN Node No." << *iter << endl;
+			ostream& outs = Log.stream();
+			outs << "Current virtual network vertexes embedding result is: \n";
+			for (vector<int>::const_iterator iter = vertex_embedding_result.begin(); iter != vertex_embedding_result.end(); iter++)
+			{
+				outs << "No." << iter - vertex_embedding_result.begin() + 1 << " Node in VN was embedded in SN Node No." << *iter << endl;
+			}
+			outs << endl;
 		}
-		outs << endl;
 	}
 
-	void get_SN_EdgeList(VONETopo::LinkList& SN_Edge, const vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge)
+	void Edges_Embedding(const VONETopo::LinkList& Virtual_Network_EdgeList, VONETopo::Graph& SN_Resource,
+		const VONESpectrum::Spectrum_Arena& SN_Spectrum, const vector<int>& vertex_embedding_result, vector<vector<int> >& edge_embedding_result, VONELog::Logger& Log)
 	{
-		for (vector<VONEHeuristic::Utilited_Edge>::const_iterator iter = SN_Utilited_Edge.begin();
-			iter != SN_Utilited_Edge.end(); iter++)
+		VONE_PROFILE_SCOPE(VONEProfile::Phase_Edges_Embedding);
+
+		//The link weights are the path distances in SN_Spectrum, which do not change while one VN is routed, 
+		//    so they are refreshed in place once and one shortest path tree is grown per distinct source substrate node:
+		for (int i = 1; i <= SN_Spectrum.get_link_num(); i++)
 		{
-			VONETopo::Edge SN_Edge_tmp;
-			SN_Edge_tmp = iter->_edge;
-			SN_Edge_tmp._edge_bandwidth = iter->_path_distance;
-			SN_Edge.push_back(SN_Edge_tmp);
+			SN_Resource.set_edge_weight(i - 1, SN_Spectrum.path_distance(i - 1));
 		}
-	}
-
-	void Edges_Embedding(const VONETopo::LinkList& Virtual_Network_EdgeList, const int Number_of_SN_Vertex,
-		const vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, const vector<int>& vertex_embedding_result, vector<vector<int> >& edge_embedding_result, ofstream& outs)
-	{
-		VONETopo::LinkList SN_Edge;
-		get_SN_EdgeList(SN_Edge, SN_Utilited_Edge);
+		map<int, VONETopo::Shortest_Path_Tree> SN_Trees;
 
 		for (VONETopo::LinkListIT liter = Virtual_Network_EdgeList.begin(); liter != Virtual_Network_EdgeList.end(); liter++)
 		{
 			//Find the shortest path:
-			VONETopo::Graph SN_Resource(Number_of_SN_Vertex, SN_Edge);
-			SN_Resource.Dijkstra(vertex_embedding_result[(liter->_edge_source)._vertex_id - 1],
-				vertex_embedding_result[(liter->_edge_destination)._vertex_id - 1]);
+			int source = vertex_embedding_result[(liter->_edge_source)._vertex_id - 1];
+			int destination = vertex_embedding_result[(liter->_edge_destination)._vertex_id - 1];
+			map<int, VONETopo::Shortest_Path_Tree>::iterator titer = SN_Trees.find(source);
+			if (titer == SN_Trees.end())
+			{
+				titer = SN_Trees.insert(make_pair(source, VONETopo::Shortest_Path_Tree())).first;
+				SN_Resource.Dijkstra(source, titer->second);
+			}
 			vector<int> Shortest_Path;
-			SN_Resource.get_shortest_path(Shortest_Path);
+			VONETopo::Graph::get_shortest_path(titer->second, destination, Shortest_Path);
 			if (Shortest_Path.size() >= 2)
 			{
-				Shortest_Path.push_back(SN_Resource.get_distance());
+				Shortest_Path.push_back(titer->second._distance[destination - 1]);
 				edge_embedding_result.push_back(Shortest_Path);
 			}
 			else
 			{
 				edge_embedding_result.clear();
-				outs << "Due to the Edge frequency capacity limit, current Virtual Network will be blocked!\n";
+				VONE_LOG(Log, VONELog::Log_Info) << "Due to the Edge frequency capacity limit, current Virtual Network will be blocked!\n";
 				break;
 			}
 		}
-		outs << "Current virtual network edges embedding result is: \n";
-		for (vector<vector<int> >::const_iterator iter1 = edge_embedding_result.begin(); iter1 != edge_embedding_result.end(); iter1++)
+		if (VONE_LOG_ON(Log, VONELog::Log_Debug))
 		{
-			outs << "No." << iter1 - edge_embedding_result.begin() + 1 << " Link in VN was embedded in SN Link ";
-			for (vector<int>::const_iterator iter2 = iter1->begin(); iter2 != prev(iter1->end()); iter2++)
+			ostream& outs = Log.stream();
+			outs << "Current virtual network edges embedding result is: \n";
+			for (vector<vector<int> >::const_iterator iter1 = edge_embedding_result.begin(); iter1 != edge_embedding_result.end(); iter1++)
 			{
-				if (iter2 != prev(prev(iter1->end())))
-					outs << *iter2 << "->";
-				else
-					outs << *iter2 << ", ";
+				outs << "No." << iter1 - edge_embedding_result.begin() + 1 << " Link in VN was embedded in SN Link ";
+				for (vector<int>::const_iterator iter2 = iter1->begin(); iter2 != prev(iter1->end()); iter2++)
+				{
+					if (iter2 != prev(prev(iter1->end())))
+						outs << *iter2 << "->";
+					else
+						outs << *iter2 << ", ";
+				}
+				outs << "with distance: " << *prev(iter1->end()) << endl;
 			}
-			outs << "with distance: " << *prev(iter1->end()) << endl;
+			outs << endl;
 		}
-		outs << endl;
 	}
 
-	void Frequency_Recovery(const vector<vector<int> >& edge_embedding_result, vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, const int CoreNumber)
+	bool Candidate_Edges_Embedding(const VONETopo::LinkList& Virtual_Network_EdgeList, const VONETopo::Topo& Substrate_Network, 
+		const vector<vector<vector<int> > >& Path_Candidate, const int Vertex_Num, const int Rank, const VONESpectrum::Spectrum_Arena& SN_Spectrum, 
+		const vector<int>& vertex_embedding_result, vector<vector<int> >& edge_embedding_result, VONELog::Logger& Log)
 	{
-		VONETopo::LinkList SN_Edge;
-		get_SN_EdgeList(SN_Edge, SN_Utilited_Edge);
-
-		for (vector<vector<int> >::const_iterator liter = edge_embedding_result.begin(); liter != edge_embedding_result.end(); liter++)
+		VONE_PROFILE_SCOPE(VONEProfile::Phase_Edges_Embedding);
+		bool rank_found = false;
+		for (VONETopo::LinkListIT liter = Virtual_Network_EdgeList.begin(); liter != Virtual_Network_EdgeList.end(); liter++)
 		{
-			for (vector<int>::const_iterator siter = liter->begin() + 1; siter != prev(liter->end()); siter++)
+			int source = vertex_embedding_result[(liter->_edge_source)._vertex_id - 1];
+			int destination = vertex_embedding_result[(liter->_edge_destination)._vertex_id - 1];
+			const vector<vector<int> >& candidate = Path_Candidate[(source - 1) * Vertex_Num + destination - 1];
+			if (candidate.empty())
 			{
-				VONETopo::LinkListIT edge_index = find_if(SN_Edge.begin(), SN_Edge.end(),
-					VONETopo::Edge_finder(*prev(siter), *siter));
-
-				//Frequency resource recovery:
-				for (int j = 1; j <= CoreNumber; j++)
+				edge_embedding_result.clear();
+				VONE_LOG(Log, VONELog::Log_Info) << "Due to the Edge frequency capacity limit, current Virtual Network will be blocked!\n";
+				break;
+			}
+			rank_found = rank_found || Rank < static_cast<int>(candidate.size());
+
+			//The cached distance is replaced by the current cost of the path:
+			vector<int> Shortest_Path(candidate[min(Rank, static_cast<int>(candidate.size()) - 1)]);
+			Shortest_Path.back() = 0;
+			for (vector<int>::const_iterator siter = Shortest_Path.begin() + 1; siter != prev(Shortest_Path.end()); siter++)
+				Shortest_Path.back() += SN_Spectrum.path_distance(Substrate_Network.find_edge(*prev(siter), *siter));
+			edge_embedding_result.push_back(Shortest_Path);
+		}
+		if (VONE_LOG_ON(Log, VONELog::Log_Debug))
+		{
+			ostream& outs = Log.stream();
+			outs << "Current virtual network edges embedding result on the candidate paths of rank " << Rank + 1 << " is: \n";
+			for (vector<vector<int> >::const_iterator iter1 = edge_embedding_result.begin(); iter1 != edge_embedding_result.end(); iter1++)
+			{
+				outs << "No." << iter1 - edge_embedding_result.begin() + 1 << " Link in VN was embedded in SN Link ";
+				for (vector<int>::const_iterator iter2 = iter1->begin(); iter2 != prev(iter1->end()); iter2++)
 				{
-					for (int i = 1; i <= SN_Utilited_Edge[0]._frequency[0].size(); i++)
-					{
-						if (SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[2 * (j - 1)][i - 1] < 0)
-							SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[2 * (j - 1)][i - 1] = 0;
-						else if (SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[2 * j - 1][i - 1] < 0)
-							SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[2 * j - 1][i - 1] = 0;
-						else
-							continue;
-					}
+					if (iter2 != prev(prev(iter1->end())))
+						outs << *iter2 << "->";
+					else
+						outs << *iter2 << ", ";
 				}
+				outs << "with distance: " << *prev(iter1->end()) << endl;
 			}
+			outs << endl;
 		}
+		return rank_found;
 	}
 
 	int Core_Index(const int node1_id, const int node2_id, const int current_core)
@@ -858,195 +2192,208 @@ namespace
 		return (node1_id < node2_id) ? (2 * (current_core - 1)) : (2 * current_core - 1);
 	}
 
-	void Core_Assignment(const vector<vector<int> >& edge_embedding_result, const vector<int> Core_Priority, const int Hetergeneous_Core,
-		vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, vector<int>& Core_Classification, int VN_Bandwidth,
-		vector<int>& core_assignment_result, int& start_frequency, const int CoreNumber, ofstream& outs)
+	void Core_Assignment(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& Core_Priority, 
+		const int Hetergeneous_Core, VONESpectrum::Spectrum_Arena& SN_Spectrum, const vector<int>& Core_Classification, const VONEHeuristic::Core_Table& Table, 
+		int VN_Bandwidth, vector<int>& core_assignment_result, int& start_frequency, const int CoreNumber, VONEHeuristic::Core_Scratch& Scratch, VONELog::Logger& Log)
 	{
-		VONETopo::LinkList SN_Edge;
-		get_SN_EdgeList(SN_Edge, SN_Utilited_Edge);
+		VONE_PROFILE_SCOPE(VONEProfile::Phase_Core_Assignment);
 
+		//The common fibers are dispatched to the instances with the number of cores fixed:
+		switch (CoreNumber)
+		{
+		case 1:
+			Fixed_Core_Assignment<1>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+			break;
+		case 2:
+			Fixed_Core_Assignment<2>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+			break;
+		case 4:
+			Fixed_Core_Assignment<4>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+			break;
+		case 7:
+			Fixed_Core_Assignment<7>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+			break;
+		case 12:
+			Fixed_Core_Assignment<12>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+			break;
+		case 19:
+			Fixed_Core_Assignment<19>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+			break;
+		default:
+			Fixed_Core_Assignment<0>(Substrate_Network, edge_embedding_result, Core_Priority, Hetergeneous_Core, SN_Spectrum, Core_Classification, Table,
+				VN_Bandwidth, core_assignment_result, start_frequency, CoreNumber, Scratch, Log);
+		}
+	}
+
+	template <int Core_Num>
+	void Fixed_Core_Assignment(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& Core_Priority, 
+		const int Hetergeneous_Core, VONESpectrum::Spectrum_Arena& SN_Spectrum, const vector<int>& Core_Classification, const VONEHeuristic::Core_Table& Table, 
+		int VN_Bandwidth, vector<int>& core_assignment_result, int& start_frequency, const int CoreNumber, VONEHeuristic::Core_Scratch& Scratch, VONELog::Logger& Log)
+	{
+		const int core_num = Core_Num == 0 ? CoreNumber : Core_Num;
 		int Service_Type = Request_Type(VN_Bandwidth);
 		if (Hetergeneous_Core != 0)
-		{
-			Core_Classification[Hetergeneous_Core - 1] = 2;
-			for (vector<int>::iterator iter = Core_Classification.begin(); iter != Core_Classification.end(); iter++)
-			{
-				if (*iter == 0)
-					*iter = -1;
-			}			
 			VN_Bandwidth = Service_Type == 2 ? VN_Bandwidth / 2 : VN_Bandwidth;
+		const VONELayout::Core_Mask service_mask = Table._service_mask[Service_Type];
+
+		//The cores allowed for the service type, in priority order:
+		typename Core_Set<Core_Num>::type Allowed_Core = Core_Set<Core_Num>::make(CoreNumber);
+		int allowed_num = 0;
+		for (int i = 1; i <= core_num; i++)
+		{
+			if (service_mask & VONELayout::Core_Bit(Table._priority[i - 1]))
+				Allowed_Core[allowed_num++] = Table._priority[i - 1];
 		}
 
-		vector<vector<int> > Aux_Core_Classification(CoreNumber);
-		for (vector<int>::iterator iter = Core_Classification.begin(); iter != Core_Classification.end(); iter++)
+		//The hops of the paths are listed once with their links, the first hop is the first link:
+		vector<int>& hop_edge = Scratch._hop_edge;
+		vector<int>& hop_source = Scratch._hop_source;
+		vector<int>& hop_destination = Scratch._hop_destination;
+		hop_edge.clear();
+		hop_source.clear();
+		hop_destination.clear();
+		for (vector<vector<int> >::const_iterator eiter = edge_embedding_result.begin(); eiter != edge_embedding_result.end(); eiter++)
 		{
-			if (*iter == 0)
-			{
-				vector<int> tmp = {1, 2, 3};
-				Aux_Core_Classification[iter - Core_Classification.begin()] = tmp;
-			}
-			else if	(*iter == -1)
+			for (vector<int>::const_iterator siter = eiter->begin() + 1; siter != prev(eiter->end()); siter++)
 			{
-				vector<int> tmp = {1, 3};
-				Aux_Core_Classification[iter - Core_Classification.begin()] = tmp;
+				hop_edge.push_back(Substrate_Network.find_edge(*prev(siter), *siter));
+				hop_source.push_back(*prev(siter));
+				hop_destination.push_back(*siter);
 			}
-			else
+		}
+		const int hop_num = static_cast<int>(hop_edge.size());
+		int first_edge_index = hop_edge[0];
+
+		//Path-wide availability of the following links: a start is available on one link when any allowed core has 
+		//    VN_Bandwidth free slots from it, so the run start masks of the allowed cores are ORed per link and then ANDed across links:
+		vector<VONESpectrum::Spectrum_Word>& following_mask = Scratch._following_mask;
+		vector<VONESpectrum::Spectrum_Word>& link_mask = Scratch._link_mask;
+		vector<VONESpectrum::Spectrum_Word>& core_mask = Scratch._core_mask;
+		vector<VONESpectrum::Spectrum_Word>& path_mask = Scratch._path_mask;
+		following_mask.assign((SN_Spectrum.get_slot_num() + VONESpectrum::Word_Bits - 1) / VONESpectrum::Word_Bits, ~0ULL);
+		for (int h = 1; h < hop_num; h++)
+		{
+			link_mask.assign(following_mask.size(), 0);
+			for (int j = 0; j < allowed_num; j++)
 			{
-				vector<int> tmp = {*iter};
-				Aux_Core_Classification[iter - Core_Classification.begin()] = tmp;
+				//The core without a long enough free run adds no start:
+				VONESpectrum::Spectrum_Bitmap occupancy = SN_Spectrum.occupancy(hop_edge[h], Core_Index(hop_source[h], hop_destination[h], Allowed_Core[j]));
+				if (occupancy.largest_free_run() < VN_Bandwidth)
+					continue;
+				occupancy.run_start_mask(VN_Bandwidth, core_mask);
+				VONESpectrum::Mask_Or(link_mask, core_mask);
 			}
+			VONESpectrum::Mask_And(following_mask, link_mask);
 		}
 
-		vector<int> Start_Frequency(CoreNumber);
-		vector<vector<int> > Core_Record;
-		for (int i = 1; i <= CoreNumber; i++)
+		typename Core_Set<Core_Num>::type Start_Frequency = Core_Set<Core_Num>::make(CoreNumber);
+		vector<vector<int> >& Core_Record = Scratch._core_record;
+		int record_num = 0;
+		vector<int>& Core_Record_tmp = Scratch._core_record_tmp;
+		VONESpectrum::Spectrum_Transaction& pre_assignment = Scratch._pre_assignment;
+		for (int i = 0; i < allowed_num; i++)
 		{
-			int core = Core_Priority[i - 1];
-			if (find(Aux_Core_Classification[core - 1].begin(), Aux_Core_Classification[core - 1].end(), Service_Type) != Aux_Core_Classification[core - 1].end())
+			int core = Allowed_Core[i];
+			int first_core_index = Core_Index(hop_source[0], hop_destination[0], core);
+			VONESpectrum::Spectrum_Bitmap first_occupancy = SN_Spectrum.occupancy(first_edge_index, first_core_index);
+			if (first_occupancy.largest_free_run() < VN_Bandwidth)
+				continue;
+			first_occupancy.run_start_mask(VN_Bandwidth, path_mask);
+			VONESpectrum::Mask_And(path_mask, following_mask);
+
+			//Only the start available on the whole path should be tried, the cores are then picked link by link, 
+			//    which still fails when two links of the VN share one substrate link and direction. The pre-assignment 
+			//    is always rolled back, so it works on the words only and leaves the free run index untouched:
+			Core_Record_tmp.clear();
+			for (int start = VONESpectrum::Lowest_Slot(path_mask); start != 0; start = VONESpectrum::Lowest_Slot(path_mask, start + 1))
 			{
-				vector<int> Core_Record_tmp;
-				for (int start = 1; start <= SN_Utilited_Edge[0]._frequency[0].size() - VN_Bandwidth + 1; start++)
+				pre_assignment.reserve(first_occupancy.unindexed(), start, VN_Bandwidth);
+				Core_Record_tmp.push_back(first_core_index);
+				VONE_PROFILE_COUNT(VONEProfile::Counter_Start_Slot_Trial, 1);
+				bool following_link_flag = true;
+				for (int h = 1; h < hop_num; h++)
 				{
-					//Clear pre-assignment:
-					if (!Core_Record_tmp.empty())
+					VONE_PROFILE_COUNT(VONEProfile::Counter_Hop_Scanned, 1);
+					bool core_flag = false;
+					for (int j = 0; j < allowed_num; j++)
 					{
-						Frequency_Recovery(edge_embedding_result, SN_Utilited_Edge, CoreNumber);
-						Core_Record_tmp.clear();
-					}
-					//Get the first link:
-					vector<vector<int> >::const_iterator eiter = edge_embedding_result.begin();
-					vector<int>::const_iterator siter = eiter->begin() + 1;
-					VONETopo::LinkListIT edge_index = find_if(SN_Edge.begin(), SN_Edge.end(),
-						VONETopo::Edge_finder(*prev(siter), *siter));
-					VONEHeuristic::Utilited_Edge SN_Utilited_Edge_tmp = SN_Utilited_Edge[edge_index - SN_Edge.begin()];
-
-					//First Link frequency slots finding:
-					int core_index = Core_Index(*prev(siter), *siter, core);
-					if (SN_Utilited_Edge_tmp._frequency[core_index][start - 1] == 0)
-					{
-						bool first_start_flag = true;
-						for (int start_tmp = start + 1; start_tmp <= start + VN_Bandwidth - 1; start_tmp++)
-						{
-							if (SN_Utilited_Edge_tmp._frequency[core_index][start_tmp - 1] == 0)
-							{
-								SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[core_index][start_tmp - 1] = -1;
-								continue;
-							}
-							else
-							{
-								first_start_flag = false;
-								break;
-							}
-						}
-						if (first_start_flag == true)
+						int core_index = Core_Index(hop_source[h], hop_destination[h], Allowed_Core[j]);
+						VONESpectrum::Spectrum_Bitmap occupancy = SN_Spectrum.occupancy(hop_edge[h], core_index);
+						if (occupancy.is_free(start, VN_Bandwidth))
 						{
+							pre_assignment.reserve(occupancy.unindexed(), start, VN_Bandwidth);
 							Core_Record_tmp.push_back(core_index);
-							bool following_link_flag = true;
-							for (vector<vector<int> >::const_iterator eiter = edge_embedding_result.begin(); eiter != edge_embedding_result.end(); eiter++)
-							{
-								for (vector<int>::const_iterator siter = eiter->begin() + 1; siter != prev(eiter->end()); siter++)
-								{
-									if (eiter == edge_embedding_result.begin() && siter == eiter->begin() + 1)
-									{
-										continue;
-									}
-									else
-									{
-										edge_index = find_if(SN_Edge.begin(), SN_Edge.end(),
-											VONETopo::Edge_finder(*prev(siter), *siter));
-										SN_Utilited_Edge_tmp = SN_Utilited_Edge[edge_index - SN_Edge.begin()];
-
-										bool core_flag = false;
-										for (int j = 1; j <= CoreNumber; j++)
-										{
-											int core_tmp = Core_Priority[j - 1];
-											if (find(Aux_Core_Classification[core_tmp - 1].begin(), Aux_Core_Classification[core_tmp - 1].end(), Service_Type) != Aux_Core_Classification[core_tmp - 1].end())
-											{
-												bool following_start_flag = true;
-												core_index = Core_Index(*prev(siter), *siter, core_tmp);
-												for (int start_tmp = start; start_tmp <= start + VN_Bandwidth - 1; start_tmp++)
-												{
-													if (SN_Utilited_Edge_tmp._frequency[core_index][start_tmp - 1] == 0)
-													{
-														SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[core_index][start_tmp - 1] = -1;
-														continue;
-													}
-													else
-													{
-														following_start_flag = false;
-														break;
-													}
-												}
-
-												if (following_start_flag == true)
-												{
-													Core_Record_tmp.push_back(core_index);
-													core_flag = true;
-													break;
-												}
-												else
-													continue;
-											}
-										}
-										if (core_flag == true)
-											continue;
-										else
-										{
-											following_link_flag = false;
-											break;
-										}
-									}
-								}
-								if (following_link_flag == false)
-									break;
-							}
-							if (following_link_flag == false)
-								continue;
-							else
-							{
-								Start_Frequency[core - 1] = start;
-								Core_Record.push_back(Core_Record_tmp);
-								Frequency_Recovery(edge_embedding_result, SN_Utilited_Edge, CoreNumber);
-								break;
-							}
+							core_flag = true;
+							break;
 						}
-						else
-							continue;
 					}
+					if (core_flag == false)
+					{
+						following_link_flag = false;
+						break;
+					}
+				}
+
+				//Clear pre-assignment:
+				pre_assignment.rollback();
+				if (following_link_flag == false)
+				{
+					VONE_PROFILE_COUNT(VONEProfile::Counter_Rollback, 1);
+					Core_Record_tmp.clear();
+					continue;
+				}
+				else
+				{
+					//The record takes the buffer of Core_Record_tmp, and leaves its own one to be reused:
+					Start_Frequency[core - 1] = start;
+					if (record_num == static_cast<int>(Core_Record.size()))
+						Core_Record.push_back(vector<int>());
+					Core_Record[record_num++].swap(Core_Record_tmp);
+					break;
 				}
 			}
 		}
 
-		if (Core_Record.empty())
+		if (record_num == 0)
 		{
-			outs << "Due to the Core Assignment limit, current Virtual Network will be blocked!\n";
+			VONE_LOG(Log, VONELog::Log_Info) << "Due to the Core Assignment limit, current Virtual Network will be blocked!\n";
 		}
 		else
 		{
-			outs << "Core Record is: \n";
-			for (int i = 1; i <= Core_Record.size(); i++)
+			if (VONE_LOG_ON(Log, VONELog::Log_Trace))
 			{
-				for (int j = 1; j <= Core_Record[i - 1].size(); j++)
+				ostream& outs = Log.stream();
+				outs << "Core Record is: \n";
+				for (int i = 1; i <= record_num; i++)
 				{
-					outs << Core_Record[i - 1][j - 1] << "\t";
+					for (int j = 1; j <= Core_Record[i - 1].size(); j++)
+					{
+						outs << Core_Record[i - 1][j - 1] << "\t";
+					}
+					outs << endl;
 				}
 				outs << endl;
-			}
-			outs << endl;
 
-			outs << "Start Frequency is: ";
-			for (int i = 1; i <= CoreNumber; i++)
-			{
-				if (i != CoreNumber)
-					outs << Start_Frequency[i - 1] << ", ";
-				else
-					outs << Start_Frequency[i - 1] << endl;
+				outs << "Start Frequency is: ";
+				for (int i = 1; i <= CoreNumber; i++)
+				{
+					if (i != CoreNumber)
+						outs << Start_Frequency[i - 1] << ", ";
+					else
+						outs << Start_Frequency[i - 1] << endl;
+				}
+				outs << endl;
 			}
-			outs << endl;
 
 			int core_assignment_index = 1;
 			int min_Start = Start_Frequency[Core_Record[0][0] / 2 + 1 - 1];
-			for (vector<vector<int> >::const_iterator Riter = Core_Record.begin(); Riter != Core_Record.end(); Riter++)
+			for (vector<vector<int> >::const_iterator Riter = Core_Record.begin(); Riter != Core_Record.begin() + record_num; Riter++)
 			{
 				if (Start_Frequency[(*Riter)[0] / 2 + 1 - 1] < min_Start)
 				{
@@ -1058,44 +2405,51 @@ namespace
 			core_assignment_result = Core_Record[core_assignment_index - 1];
 		}
 
-		outs << "Core Priority is: ";
-		for (int i = 1; i <= CoreNumber; i++)
+		if (VONE_LOG_ON(Log, VONELog::Log_Trace))
 		{
-			if (i != CoreNumber)
-				outs << Core_Priority[i - 1] << ", ";
-			else
-				outs << Core_Priority[i - 1] << endl;
-		}
-		outs << endl;
+			ostream& outs = Log.stream();
+			outs << "Core Priority is: ";
+			for (int i = 1; i <= CoreNumber; i++)
+			{
+				if (i != CoreNumber)
+					outs << Core_Priority[i - 1] << ", ";
+				else
+					outs << Core_Priority[i - 1] << endl;
+			}
+			outs << endl;
 
-		outs << "Core Classification is: ";
-		for (int i = 1; i <= CoreNumber; i++)
-		{
-			if (i != CoreNumber)
-				outs << Core_Classification[i - 1] << ", ";
-			else
-				outs << Core_Classification[i - 1] << endl;
+			outs << "Core Classification is: ";
+			for (int i = 1; i <= CoreNumber; i++)
+			{
+				if (i != CoreNumber)
+					outs << Core_Classification[i - 1] << ", ";
+				else
+					outs << Core_Classification[i - 1] << endl;
+			}
+			outs << endl;
 		}
-		outs << endl;
 
-		outs << "Current Virtual Network Cores Assignment Result is: ";
-		for (vector<int>::const_iterator iter = core_assignment_result.begin(); iter != core_assignment_result.end(); iter++)
+		if (VONE_LOG_ON(Log, VONELog::Log_Debug))
 		{
-			if (iter != prev(core_assignment_result.end()))
-				outs << "Core " << (*iter) / 2 + 1 << "--";
-			else
-				outs << "Core " << (*iter) / 2 + 1 << ", ";
+			ostream& outs = Log.stream();
+			outs << "Current Virtual Network Cores Assignment Result is: ";
+			for (vector<int>::const_iterator iter = core_assignment_result.begin(); iter != core_assignment_result.end(); iter++)
+			{
+				if (iter != prev(core_assignment_result.end()))
+					outs << "Core " << (*iter) / 2 + 1 << "--";
+				else
+					outs << "Core " << (*iter) / 2 + 1 << ", ";
+			}
+			outs << "with start frequency: " << start_frequency << endl;
+			outs << endl;
 		}
-		outs << "with start frequency: " << start_frequency << endl;
-		outs << endl;
 	}
 
-	void Frequency_Allocating(const vector<vector<int> >& edge_embedding_result, const vector<int> core_assignment_result, const int start_frequency,
-		const int Hetergeneous_Core, vector<VONEHeuristic::Utilited_Edge>& SN_Utilited_Edge, int VN_Bandwidth)
+	void Frequency_Allocating(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& core_assignment_result, 
+		const int start_frequency, const int Hetergeneous_Core, const VONELayout::Core_Layout& Layout, VONESpectrum::Spectrum_Arena& SN_Spectrum, int VN_Bandwidth, 
+		VONESpectrum::Spectrum_Transaction* Undo)
 	{
-		VONETopo::LinkList SN_Edge;
-		get_SN_EdgeList(SN_Edge, SN_Utilited_Edge);
-
+		VONE_PROFILE_SCOPE(VONEProfile::Phase_Frequency_Allocating);
 		int Service_Type = Request_Type(VN_Bandwidth);
 		if (Hetergeneous_Core != 0)
 		{
@@ -1103,32 +2457,65 @@ namespace
 		}
 
 		int index = 1;
+		VONESpectrum::Spectrum_Transaction allocation;
 		for (vector<vector<int> >::const_iterator liter = edge_embedding_result.begin(); liter != edge_embedding_result.end(); liter++)
 		{
 			for (vector<int>::const_iterator siter = liter->begin() + 1; siter != prev(liter->end()); siter++)
 			{
-				VONETopo::LinkListIT edge_index = find_if(SN_Edge.begin(), SN_Edge.end(),
-					VONETopo::Edge_finder(*prev(siter), *siter));
+				int edge_index = Substrate_Network.find_edge(*prev(siter), *siter);
 				//Frequency resource allocated:
 
-				for (int j = 1; j <= VN_Bandwidth; j++)
-				{
-					SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[core_assignment_result[index - 1]][start_frequency - 1 + j - 1] = Service_Type;
-				}
-
-				for (int i = static_cast<int>(SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[core_assignment_result[index - 1]].size()); i >= 1; i--)
-				{
-					if (SN_Utilited_Edge[edge_index - SN_Edge.begin()]._frequency[core_assignment_result[index - 1]][i - 1] != 0)
-					{
-						SN_Utilited_Edge[edge_index - SN_Edge.begin()]._end_slot[core_assignment_result[index - 1] / 2 + 1 - 1] = i;
-						break;
-					}
-				}
-				vector<int>::iterator max_iter = max_element(SN_Utilited_Edge[edge_index - SN_Edge.begin()]._end_slot.begin(),
-					SN_Utilited_Edge[edge_index - SN_Edge.begin()]._end_slot.end());
-				SN_Utilited_Edge[edge_index - SN_Edge.begin()]._path_distance = *max_iter;
+				SN_Spectrum.assign(edge_index, core_assignment_result[index - 1], start_frequency, VN_Bandwidth, Service_Type, 
+					Layout.crosstalk_mask(core_assignment_result[index - 1] / 2 + 1, Hetergeneous_Core));
+				allocation.reserve(SN_Spectrum.occupancy(edge_index, core_assignment_result[index - 1]), start_frequency, VN_Bandwidth);
+				Update_End_Slot(SN_Spectrum, edge_index, core_assignment_result[index - 1], Undo);
 				index++;
 			}
 		}
+		allocation.commit();
+	}
+
+	void Update_End_Slot(VONESpectrum::Spectrum_Arena& SN_Spectrum, const int Link, const int Core_Index, VONESpectrum::Spectrum_Transaction* Undo)
+	{
+		if (Undo != NULL)
+		{
+			Undo->save_end_slot(SN_Spectrum, Link, Core_Index / 2 + 1);
+			Undo->save_path_distance(SN_Spectrum, Link);
+		}
+		SN_Spectrum.end_slot(Link, Core_Index / 2 + 1) = max(1, SN_Spectrum.highest_used_slot(Link, Core_Index));
+		int max_end_slot = SN_Spectrum.end_slot(Link, 1);
+		for (int j = 2; j <= SN_Spectrum.get_core_num(); j++)
+		{
+			max_end_slot = max(max_end_slot, SN_Spectrum.end_slot(Link, j));
+		}
+		SN_Spectrum.set_path_distance(Link, max_end_slot);
+	}
+
+	bool Same_Paths(const vector<vector<int> >& edge_embedding_result, const vector<vector<int> >& Other_Result)
+	{
+		if (edge_embedding_result.size() != Other_Result.size())
+			return false;
+		for (vector<vector<int> >::const_iterator liter = edge_embedding_result.begin(), oiter = Other_Result.begin(); 
+			liter != edge_embedding_result.end(); liter++, oiter++)
+		{
+			if (liter->size() != oiter->size() || !equal(liter->begin(), prev(liter->end()), oiter->begin()))
+				return false;
+		}
+		return true;
+	}
+
+	bool Core_Assignment_Free(const VONETopo::Topo& Substrate_Network, const vector<vector<int> >& edge_embedding_result, const vector<int>& core_assignment_result, 
+		const int start_frequency, const int Width, const VONESpectrum::Spectrum_Arena& SN_Spectrum)
+	{
+		vector<int>::const_iterator citer = core_assignment_result.begin();
+		for (vector<vector<int> >::const_iterator liter = edge_embedding_result.begin(); liter != edge_embedding_result.end(); liter++)
+		{
+			for (vector<int>::const_iterator siter = liter->begin() + 1; siter != prev(liter->end()); siter++, citer++)
+			{
+				if (!SN_Spectrum.occupancy(Substrate_Network.find_edge(*prev(siter), *siter), *citer).is_free(start_frequency, Width))
+					return false;
+			}
+		}
+		return true;
 	}
 }
\ No newline at end of file
@@ -8,6 +8,16 @@
 
 #pragma once
 #include "Topo.h"
+#include "Spectrum.h"
+#include "Logger.h"
+
+#include <array>
+#include <memory>
+
+namespace VONEResult
+{
+	class Result_Sink;
+}
 
 namespace VONEHeuristic
 {
@@ -19,15 +29,77 @@ namespace VONEHeuristic
 		int _remaining_computing_resource;
 	};
 
-	//The set of Embedded Edges, each edge includes four properties: 
-	//    properties in STRUCT Edge, Remaining Bandwidth, 
-	//    Frequency Status and End Frequency Slot allocating status of  each core
-	struct Utilited_Edge
+	//The cores which may carry each service type, computed once from the Core Priority and the Core Classification
+	//    so that Core_Assignment tests a bit instead of searching the classification of each core
+	struct Core_Table
+	{
+		vector<int> _priority;								//The cores in priority order
+		array<VONELayout::Core_Mask, 4> _service_mask;		//The cores allowed for the service type 1, 2 and 3
+	};
+
+	//The buffers of Core_Assignment, kept by each heuristic and reused by its calls so that a call allocates 
+	//    nothing once they have grown to the longest path and the widest spectrum met
+	struct Core_Scratch
+	{
+		vector<int> _hop_edge;								//The substrate link of each hop of the paths
+		vector<int> _hop_source;
+		vector<int> _hop_destination;
+		vector<VONESpectrum::Spectrum_Word> _following_mask;	//The starts available on all the links after the first one
+		vector<VONESpectrum::Spectrum_Word> _link_mask;
+		vector<VONESpectrum::Spectrum_Word> _core_mask;
+		vector<VONESpectrum::Spectrum_Word> _path_mask;
+		vector<vector<int> > _core_record;					//The cores found from each first core, of which only those of the call are read
+		vector<int> _core_record_tmp;
+		VONESpectrum::Spectrum_Transaction _pre_assignment;
+	};
+
+	//The K shortest paths of each pair of substrate nodes, built once for a substrate network and K 
+	//    and then shared read only by the heuristics working on the same substrate network, such as the replicas of the parallel solves
+	struct Path_Candidate
+	{
+		int _k;
+		int _vertex_num;
+		vector<array<int, 3> > _edge;				//The source, the destination and the frequency slot number of each substrate edge
+		vector<vector<vector<int> > > _path;		//Indexed as [(source - 1) * _vertex_num + destination - 1][rank]
+	};
+
+	//The step at which a virtual network is blocked
+	enum Block_Reason
+	{
+		Not_Blocked,
+		Vertex_Blocked,		//No substrate node left with enough computing resource
+		Edge_Blocked,		//No path between the substrate nodes of a virtual link
+		Core_Blocked		//No core and start frequency slot free along the paths
+	};
+
+	//The results of the embedding steps of one virtual network
+	struct Embedding_Result
 	{
-		VONETopo::Edge _edge;
-		int _path_distance;
-		vector<vector<int> > _frequency;
-		vector<int> _end_slot;
+		int _handle;						//The handle to release the virtual network, or -1 when it is blocked
+		Block_Reason _block_reason;
+		vector<int> _vertex;				//The substrate node of each virtual node, empty when the vertexes embedding is blocked
+		vector<vector<int> > _edge;			//The substrate path of each virtual link followed by its distance
+		vector<int> _core;					//The core index of each hop of the paths
+		int _start_frequency;
+		int _width;							//The number of frequency slots on each hop
+		int _service_type;
+	};
+
+	ostream& operator <<(ostream& outs, const Embedding_Result& Result);
+	//Precondition: outs has been connected to an out stream
+	//Postcondition: Print the handle and the embedding of Result, or the reason why it is blocked, to outs
+
+	//The resources held by one embedded virtual network in one block, which is all that is needed to return them when it departs. 
+	//    _resource holds the index of the substrate node and the computing resource of each virtual node, 
+	//    and then the link and the core index of each hop
+	struct Allocation
+	{
+		int _vertex_num;
+		int _hop_num;
+		int _start_frequency;
+		int _width;
+		int _service_type;
+		vector<int> _resource;
 	};
 
 	////Create Heuristic class to solve VONE and store the embedding solutions
@@ -36,26 +108,242 @@ namespace VONEHeuristic
 	public:
 		VONEHeuristic();
 
+		VONEHeuristic(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout, 
+			int HeterogeneousCoreIndex, string CrosstalkYesorNo);
+		//Precondition: The same as the function prepare
+		//Postcondition: The heuristic works as an online engine on Substrate_Network, which has been prepared once 
+		//    so that the virtual networks can be embedded and released one by one
+
 		void solve(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List,
 			int CoreNumber, int HeterogeneousCoreIndex, string CrosstalkYesorNo);
 		//Precondition: Topologies of substrate netwrok and virtual networks have been assigned
-		//Postcondition: Solve the heuristic of VONE based on the Substrate_Network and Virtual_Network_List
+		//Postcondition: Solve the heuristic of VONE based on the Substrate_Network and Virtual_Network_List with CoreNumber cores in a ring
+
+		void solve(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo);
+		//Precondition: Topologies of substrate netwrok and virtual networks have been assigned, and Layout has been built
+		//Postcondition: Solve the heuristic of VONE based on the Substrate_Network and Virtual_Network_List with the cores arranged as Layout
+
+		void solve_multistart(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, 
+			const int Start_Num, const int Thread_Num = 0, const unsigned int Seed = 1);
+		//Precondition: The same as the function solve, Start_Num >= 1 and Thread_Num >= 0
+		//Postcondition: Start_Num orderings of Virtual_Network_List have been solved on Thread_Num threads, or one per hardware thread when it is 0, 
+		//    each on its own copy of the substrate state. The first is the ordering of solve, and the others cycle through the size, 
+		//    the spectrum demand and the computing demand with the ties broken at random, and a random ordering. 
+		//    The one with the fewest blocks, and then the lowest Maximum Frequency Slot Index, is kept as the solution 
+		//    with Virtual_Network_List in its order. The results are the same for any Thread_Num
+
+		void solve_anytime(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, 
+			const double Time_Budget, const unsigned int Seed = 1);
+		//Precondition: The same as the function solve, and Time_Budget >= 0 is in milliseconds
+		//Postcondition: The sorted virtual networks have been embedded one by one as embed does, and the solution has been improved 
+		//    by simulated annealing until Time_Budget has passed, where each move inserts a blocked virtual network, shifts the frequency slots 
+		//    of one to a lower start, swaps the core of one hop of one for another allowed core, or releases up to three and embeds them again 
+		//    in a random order. The objective is read from the running metrics of the spectrum, and a rejected move is undone by its inverse 
+		//    and the End Frequency Slots and the Path Distances it has recorded, so that each move costs what it has touched. 
+		//    The best solution found, with the fewest blocks, then the lowest Maximum Frequency Slot Index and then the lowest sum of 
+		//    the Path Distances, is kept with the results in the order of the sorted Virtual_Network_List. 
+		//    Unlike solve, the computing resource of a blocked virtual network is returned. 0 keeps the greedy solution
+
+		void solve_parallel(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, const int Thread_Num = 0);
+		//Precondition: The same as the function solve, and Thread_Num >= 0
+		//Postcondition: The same solution and records as solve, for any Thread_Num, on Thread_Num threads or one per hardware thread when it is 0. 
+		//    The substrate nodes of all virtual networks are chosen first in order, and then their core assignments are speculated in waves 
+		//    on replicas of the spectrum which catch up with the commits. They are committed in order, where the edges embedding runs again 
+		//    and the speculated core assignment is taken while its frequency slots are still free. Only the core assignment runs in parallel, 
+		//    so the gain follows its share of the embedding time, which is the largest with candidate paths. The records of the vertexes 
+		//    embedding come first in the log, and those of the core assignments taken from the speculation are left out
+
+		void solve_concurrent(const VONETopo::Topo& Substrate_Network, vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, const int Thread_Num = 0);
+		//Precondition: The same as the function solve, and Thread_Num >= 0
+		//Postcondition: The sorted virtual networks have been handed out to Thread_Num threads, or one per hardware thread when it is 0, 
+		//    each embedding them as embed does on its own replica of the substrate state and committing them to the shared state 
+		//    without a lock, by compare and swap on the occupancy words and atomic subtraction of the computing resource. 
+		//    A virtual network is embedded again when another thread has committed after its replica caught up, so each one 
+		//    has been embedded on the state of all the commits before it. The results are therefore those of calling embed 
+		//    on the virtual networks in the order they were committed, blocked ones included, though the order may differ
+		//    from the sorted one and from run to run when Thread_Num > 1.
+		//    With one thread it is the sorted order. 
+		//    The substrate state is left as an online engine holding the embedded virtual networks, whose handles are in the records
+
+		void prepare(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout, 
+			int HeterogeneousCoreIndex, string CrosstalkYesorNo);
+		//Precondition: Topology of substrate network has been assigned, and Layout has been built
+		//Postcondition: The substrate state has been built with all resources idle and no virtual network embedded, 
+		//    so that the virtual networks can be embedded and released one by one. The request and block counts and the results 
+		//    of an earlier solve have been cleared
+
+		Embedding_Result embed(const VONETopo::Topo& Virtual_Network);
+		//Precondition: prepare has been excuted, and topology of Virtual_Network has been assigned
+		//Postcondition: Return the embedding of Virtual_Network with its handle, or with the reason when it is blocked, 
+		//    in which case all the resources taken on the way have been returned
+
+		void release(const int Handle);
+		//Precondition: Handle has been returned by embed and not released yet
+		//Postcondition: The computing resource and the frequency slots of the virtual network have been returned to the substrate network, 
+		//    and the End Frequency Slots and the Path Distances of its links have been updated, in the time of its hops and frequency slots
+
+		void set_path_candidate_num(const int K);
+		//Precondition: K >= 0
+		//Postcondition: The virtual links are embedded on the K shortest paths of each pair of substrate nodes, which are cached once per substrate network, 
+		//    trying the paths of the same rank for all links in order until the core assignment succeeds. 
+		//    0 embeds them on the shortest paths weighted by the Path Distances, which is the default
+
+		void set_log_level(const VONELog::Log_Level Level);
+		//Postcondition: solve writes the records up to Level into log.dat, where Log_Trace keeps all of them, which is the default, 
+		//    and Log_Off does not create the file
+
+		void set_logger(VONELog::Logger* Log);
+		//Precondition: Log is NULL or outlives its use by prepare and embed
+		//Postcondition: prepare and embed write their records into Log, and nothing when it is NULL, which is the default
+
+		void set_result_sink(VONEResult::Result_Sink* Sink);
+		//Precondition: Sink is NULL or outlives its use by solve and embed
+		//Postcondition: solve and embed append the record of each virtual network to Sink as soon as it has been embedded or blocked, 
+		//    counted from 1 since prepare, and solve appends the summary after the last one. The handles in the records of solve are -1, 
+		//    since it keeps all virtual networks. NULL writes nothing, which is the default
+
+		void set_spectrum_dump(const bool Dump);
+		//Postcondition: operator << prints the service type of each frequency slot of each core when Dump is true, 
+		//    which is false by default, the same as the spectrum dump of a result sink
+
+		int defragment(const double Time_Budget);
+		//Precondition: prepare has been excuted, and Time_Budget > 0 is in milliseconds
+		//Postcondition: The embedded virtual networks holding the Maximum Frequency Slot Index of a core and direction have been moved 
+		//    to lower start frequency slots on the same paths, the highest first, until none is left or Time_Budget has passed. 
+		//    Each one is moved make-before-break onto the cores allowed for its service type. Return the number of the moved virtual networks
+
+		int get_active_num() const;
+		//Postcondition: Return the number of the virtual networks embedded and not released yet
+
+		const VONESpectrum::Spectrum_Arena& get_spectrum() const;
+		//Postcondition: Return the spectrum state of the substrate network, whose Maximum Frequency Slot Index, 
+		//    Fragmetation and Crosstalk are kept up to date during solve
 
 		friend ostream& operator <<(ostream& outs, const VONEHeuristic& VONEHeuristic);
 		//Precondition: outs has been connected to an out stream
-		//Postcondition: Print the solution information of the heuristic solution to outs
+		//Postcondition: Print the solution information of the heuristic solution to outs, 
+		//    with the frequency slots of each core only when set_spectrum_dump has been set
 
 		~VONEHeuristic();
 
 	private:
+		void prepare(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout, 
+			int HeterogeneousCoreIndex, string CrosstalkYesorNo, VONELog::Logger& Log);
+		//Precondition: The same as the public function prepare
+		//Postcondition: The same as the public function prepare, and the Core Priority and Core Classification have been recorded into Log
+
+		void solve_ordered(const VONETopo::Topo& Substrate_Network, const vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, VONELog::Logger& Log, const int Thread_Num = 1);
+		//Precondition: The same as the function solve, and Thread_Num >= 1
+		//Postcondition: The virtual networks have been embedded in the order of Virtual_Network_List, with the records written into Log, 
+		//    by embed_in_waves when Thread_Num > 1
+
+		void embed_in_waves(const VONETopo::Topo& Substrate_Network, const vector<VONETopo::Topo>& Virtual_Network_List,
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo, const int Thread_Num, 
+			vector<Embedding_Result>& Record, VONELog::Logger& Log);
+		//Precondition: prepare has been excuted with the other parameters, and Thread_Num > 1
+		//Postcondition: Record holds the result of embed_request without returning the computing resource for each virtual network, 
+		//    which have been embedded in the order of Virtual_Network_List. The core assignments of Thread_Num * Wave_Factor of them 
+		//    at once have been speculated on Thread_Num threads, and taken by embed_links on the real spectrum
+
+		bool embed_request(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record, const bool Return_on_Block, VONELog::Logger& Log);
+		//Precondition: prepare has been excuted
+		//Postcondition: The vertexes embedding, edges embedding, core assignment and frequency allocating have been excuted in turn, 
+		//    Record holds the results of the steps up to the blocked one, which is left empty, and the block reason. 
+		//    Return whether Virtual_Network has been embedded. 
+		//    The computing resource taken by a blocked virtual network is returned only when Return_on_Block is true
+
+		bool embed_vertexes(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record, const bool Return_on_Block, VONELog::Logger& Log);
+		//Precondition: prepare has been excuted
+		//Postcondition: The vertexes embedding of embed_request has been excuted, and return whether it has succeeded
+
+		bool embed_links(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record, const bool Return_on_Block, VONELog::Logger& Log, 
+			int* Rank = NULL, const Embedding_Result* Speculation = NULL, const int Speculated_Rank = 0);
+		//Precondition: embed_vertexes has succeeded for Virtual_Network and Record. Speculation is NULL, or it has been given by embed_links 
+		//    for the same substrate nodes, stopping at the rank Speculated_Rank, on an earlier spectrum whose frequency slots are all still taken
+		//Postcondition: The edges embedding and the core assignment of embed_request have been excuted without changing the spectrum, 
+		//    and return whether they have succeeded. Rank holds the rank of the candidate paths tried last when it is not NULL. 
+		//    The core assignments already made by Speculation are not searched again, since taking more frequency slots never makes 
+		//    a start frequency slot succeed, so a start which has failed still fails and the one found stays the first while it is free
+
+		void allocate_frequency(const VONETopo::Topo& Virtual_Network, Embedding_Result& Record);
+		//Precondition: embed_links has succeeded for Virtual_Network and Record
+		//Postcondition: The frequency slots of Record have been allocated, and its service type and width have been set
+
+		bool repack(Allocation& Record);
+		//Precondition: Record is held by an embedded virtual network
+		//Postcondition: The frequency slots of Record have been moved to the lowest start frequency slot below the current one 
+		//    which is free on an allowed core of each hop, taking the new slots before returning the old ones. Return whether it has been moved
+
+		bool swap_core(Allocation& Record, const int Hop, const int Core);
+		//Precondition: Record is held by an embedded virtual network, 0 <= Hop < Record._hop_num and 1 <= Core <= CoreNumber
+		//Postcondition: The frequency slots of the hop Hop of Record have been moved to Core at the same start frequency slot 
+		//    in the same direction, taking the new slots before returning the old ones, when Core is another core allowed for 
+		//    its service type and the slots are free there. Return whether it has been moved
+
+		int restore(const Allocation& Record);
+		//Precondition: Record has been packed from a virtual network released since, whose resources are free
+		//Postcondition: The resources of Record have been taken again exactly as they were. Return the new handle of the virtual network
+
+		int restore_ranked(const Allocation& Record);
+		//Precondition: Record is empty, with _vertex_num 0, for a blocked virtual network, or the same as the function restore
+		//Postcondition: The substrate nodes have been sorted as the vertexes embedding sorts them before each virtual network, 
+		//    and then Record has been restored. Return the new handle, or -1 when Record is empty
+
+		long long energy(const int Block_Num) const;
+		//Postcondition: Return the objective of the simulated annealing for the current spectrum and Block_Num blocks, 
+		//    which orders the blocks first, then the Maximum Frequency Slot Index and then the sum of the Path Distances. 
+		//    It reads the maximum and the sum kept by the spectrum, in constant time
+
+		int new_handle();
+		//Postcondition: Return a handle which is free, taken from _free_handle or appended to _allocation
+
+		void build_path_candidate(const VONETopo::Topo& Substrate_Network);
+		//Postcondition: _path_candidate holds the _path_candidate_num shortest paths of each pair of nodes of Substrate_Network, 
+		//    kept as they were when they have been built for the same substrate network and number, and NULL when the number is 0
+
+		void share_path_candidate(VONEHeuristic& Replica) const;
+		//Postcondition: Replica uses the number of candidate paths and the candidate paths of this heuristic, without building them again
+
+		void return_computing(const VONETopo::Topo& Virtual_Network, const Embedding_Result& Record);
+		//Precondition: Record._vertex holds the substrate nodes taken by the virtual nodes of Virtual_Network
+		//Postcondition: The computing resource of the virtual nodes has been returned to the substrate nodes
+
+		void pack(const VONETopo::Topo& Virtual_Network, const Embedding_Result& Record, Allocation& Packed) const;
+		//Precondition: Virtual_Network has been embedded as Record
+		//Postcondition: The resources held by Virtual_Network have been packed into Packed
+
+		VONETopo::Topo _substrate;
+		VONELayout::Core_Layout _layout;
+		int _hetergeneous_core;
+		vector<Utilited_Vertex> _sn_vertex;
+		vector<int> _sn_position;			//The position in _sn_vertex of each substrate node, indexed as the vertexes of _substrate
+		VONETopo::Graph _sn_resource;
+		vector<int> _core_priority;
+		vector<int> _core_classification;
+		Core_Table _core_table;
+		Core_Scratch _core_scratch;
+		int _path_candidate_num;
+		shared_ptr<const Path_Candidate> _path_candidate;
+		vector<Allocation> _allocation;		//Indexed by the handle, the released ones are empty and listed in _free_handle
+		vector<int> _free_handle;
+		VONELog::Log_Level _log_level;
+		VONELog::Logger* _logger;
+		VONEResult::Result_Sink* _result_sink;
+		bool _spectrum_dump;
+		int _request_num;					//The virtual networks embedded or blocked since prepare
+		VONESpectrum::Spectrum_Transaction* _undo;	//Records the End Frequency Slots and the Path Distances changed, when it is not NULL
+
 		vector<vector<int> > _vertex_embedding_result;
 		vector<vector<vector<int> > > _edge_embedding_result;
 		vector<vector<int> > _core_assignment_result;
 		vector<int> _start_frequency_result;
-		vector<vector<vector<int> > > _frequency_allocating_result;
-		vector<vector<int> > _maximum_frequency_slot_index;
-		vector<vector<int> > _fragmetation;
-		vector<int> _crosstalk;
+		VONESpectrum::Spectrum_Arena _spectrum;
 		int _block_num;
 	};
 }
\ No newline at end of file
@@ -184,11 +184,12 @@ namespace
 		const int Substrate_Network_Edge_Number,
 		const vector<int> Virtual_Networks_Bandwidth,
 		const int C,
+		const VONELayout::Core_Layout& Layout,
 		const bool Cross_Talk_Flag = false);
 	//Precondition: The function getILPVertexInputParameter and getILPEdgeInputParameter have been excuted, so Request_Number,
 	//    Substrate_Network_Edge_Number and Virtual_Networks_Bandwidth were assigned. And x and y must be added into the array.
-	//    C has been initialized. Cross_Talk_Flag indicates that whether the cross-talk between two adjacent cores should be 
-	//    taken into account or not.
+	//    C has been initialized, and Layout arranges the C cores. Cross_Talk_Flag indicates that whether the cross-talk between 
+	//    two adjacent cores should be taken into account or not.
 	//Postcondition: The constraint of spectrum consistency in optical network has been added to the model mod.
 
 	void constraints8_heter
@@ -200,11 +201,12 @@ namespace
 		const vector<int> Virtual_Networks_Bandwidth,
 		const int C,
 		const int C_Heter,
+		const VONELayout::Core_Layout& Layout,
 		const bool Cross_Talk_Flag = false);
 	//Precondition: The function getILPVertexInputParameter and getILPEdgeInputParameter have been excuted, so Request_Number,
 	//    Substrate_Network_Edge_Number and Virtual_Networks_Bandwidth were assigned. And x and y must be added into the array. 
-	//    C and C_Heter have been initialized. Cross_Talk_Flag indicates that whether the cross-talk between two adjacent cores 
-	//    should be taken into account or not.
+	//    C and C_Heter have been initialized, and Layout arranges the C cores. Cross_Talk_Flag indicates that whether the cross-talk 
+	//    between two adjacent cores should be taken into account or not.
 	//Postcondition: The constraint of spectrum consistency in hetergeneous cores of optical network has been added to the model mod.
 }
 namespace VONEILP
@@ -221,6 +223,14 @@ namespace VONEILP
 		const vector<VONETopo::Topo>& Virtual_Network_List,
 		int CoreNumber, int HeterogeneousCoreIndex, string CrosstalkYesorNo)
 	{
+		solve(Substrate_Network, Virtual_Network_List, VONELayout::Core_Layout(CoreNumber), HeterogeneousCoreIndex, CrosstalkYesorNo);
+	}
+
+	void VONECplex::solve(const VONETopo::Topo& Substrate_Network,
+		const vector<VONETopo::Topo>& Virtual_Network_List,
+		const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo)
+	{
+		int CoreNumber = Layout.get_core_num();
 		int RNum;
 		int SVNum;
 		vector<int> VVNum;
@@ -289,12 +299,12 @@ namespace VONEILP
 			{
 				if ((CrosstalkYesorNo == "Yes") || (CrosstalkYesorNo == "yes"))
 				{
-					constraints8(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, false);
+					constraints8(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, Layout, false);
 					ModelLPFileName = "VONEonMCFwithCrosstalk";
 				}					
 				else
 				{
-					constraints8(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, true);
+					constraints8(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, Layout, true);
 					ModelLPFileName = "VONEonMCFwithoutCrosstalk";
 				}		
 			}
@@ -302,12 +312,12 @@ namespace VONEILP
 			{
 				if ((CrosstalkYesorNo == "Yes") || (CrosstalkYesorNo == "yes"))
 				{
-					constraints8_heter(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, HeterogeneousCoreIndex, false);
+					constraints8_heter(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, HeterogeneousCoreIndex, Layout, false);
 					ModelLPFileName = "VONEonHMCFwithCrosstalk";
 				}					
 				else
 				{
-					constraints8_heter(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, HeterogeneousCoreIndex, true);
+					constraints8_heter(_model, Core_r_c_s_d, f_r, RNum, SENum, VEBw, CoreNumber, HeterogeneousCoreIndex, Layout, true);
 					ModelLPFileName = "VONEonHMCFwithoutCrosstalk";
 				}					
 			}
@@ -806,6 +816,7 @@ namespace
 		const int Substrate_Network_Edge_Number,
 		const vector<int> Virtual_Networks_Bandwidth,
 		const int C,
+		const VONELayout::Core_Layout& Layout,
 		const bool Cross_Talk_Flag)
 	{
 		IloEnv env = mod.getEnv();
@@ -842,62 +853,35 @@ namespace
 
 						if (Cross_Talk_Flag == true && Omega_r1 == Omega_r2 && C > 1)
 						{
-							//Taking the cross-talk between two adjacent cores into account:
-							IloExpr	font_adjacent_core_con1(env), back_adjacent_core_con1(env),
-								font_adjacent_core_con2(env), back_adjacent_core_con2(env);
-
-							font_adjacent_core_con1 = x[2 * (c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[2 * ((c + C) % C + 1 - 1) //font adjacent core index equals to the back
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							font_adjacent_core_con2 = x[(2 * c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[(2 * ((c + C) % C + 1) - 1) //font adjacent core index equals to the back
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							back_adjacent_core_con1 = x[2 * (c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[2 * ((c + C - 2) % C + 1 - 1) //back adjacent core index
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							back_adjacent_core_con2 = x[(2 * c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[(2 * ((c + C - 2) % C + 1) - 1) //back adjacent core index
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							if (C == 2)
+							//Taking the cross-talk between the core and its adjacent cores into account, which are 
+							//    counted by the neighbour mask of the core layout instead of the front and back cores of a ring:
+							IloExpr	adjacent_core_con1(env), adjacent_core_con2(env);
+							adjacent_core_con1 += (same_core_con1 == 2);
+							adjacent_core_con2 += (same_core_con2 == 2);
+							for (VONELayout::Core_Mask mask = Layout.neighbour_mask(c); mask != 0; mask &= mask - 1)
 							{
-								mod.add(IloIfThen(env,
-									(same_core_con1 == 2) + (font_adjacent_core_con1 == 2) == 1,
-									spectrum_consistency_con == 1)); //font adjacent core index equals to the back
-
-								mod.add(IloIfThen(env,
-									(same_core_con2 == 2) + (font_adjacent_core_con2 == 2) == 1,
-									spectrum_consistency_con == 1)); //font adjacent core index equals to the back
-							}
-							else
-							{
-								mod.add(IloIfThen(env,
-									(same_core_con1 == 2)
-									+ (font_adjacent_core_con1 == 2) //font adjacent core index
-									+ (back_adjacent_core_con1 == 2) == 1, //back adjacent core index
-									spectrum_consistency_con == 1));
-
-								mod.add(IloIfThen(env,
-									(same_core_con2 == 2)
-									+ (font_adjacent_core_con2 == 2) //font adjacent core index
-									+ (back_adjacent_core_con2 == 2) == 1, //back adjacent core index
-									spectrum_consistency_con == 1));
+								int adjacent_core = VONELayout::Lowest_Core(mask);
+
+								adjacent_core_con1 += (x[2 * (c - 1)
+									+ (sd - 1) * C * 2
+									+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
+									x[2 * (adjacent_core - 1)
+									+ (sd - 1) * C * 2
+									+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number] == 2);
+
+								adjacent_core_con2 += (x[(2 * c - 1)
+									+ (sd - 1) * C * 2
+									+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
+									x[(2 * adjacent_core - 1)
+									+ (sd - 1) * C * 2
+									+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number] == 2);
 							}
+
+							mod.add(IloIfThen(env,
+								adjacent_core_con1 == 1, spectrum_consistency_con == 1));
+
+							mod.add(IloIfThen(env,
+								adjacent_core_con2 == 1, spectrum_consistency_con == 1));
 						}
 						else
 						{
@@ -923,6 +907,7 @@ namespace
 		const vector<int> Virtual_Networks_Bandwidth,
 		const int C,
 		const int C_Heter,
+		const VONELayout::Core_Layout& Layout,
 		const bool Cross_Talk_Flag)
 	{
 		IloEnv env = mod.getEnv();
@@ -963,122 +948,49 @@ namespace
 						if (Cross_Talk_Flag == true && Omega_r1 == Omega_r2 && C > 2)
 						{
 							//Taking the cross-talk between two adjacent cores into account:
-							IloExpr	font_adjacent_core_con1(env), back_adjacent_core_con1(env),
-								font_adjacent_core_con2(env), back_adjacent_core_con2(env);
-
-							font_adjacent_core_con1 = x[2 * (c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[2 * ((c + C) % C + 1 - 1) //font adjacent core index equals to the back
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							font_adjacent_core_con2 = x[(2 * c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[(2 * ((c + C) % C + 1) - 1) //font adjacent core index equals to the back
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							back_adjacent_core_con1 = x[2 * (c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[2 * ((c + C - 2) % C + 1 - 1) //back adjacent core index
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							back_adjacent_core_con2 = x[(2 * c - 1)
-								+ (sd - 1) * C * 2
-								+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-								x[(2 * ((c + C - 2) % C + 1) - 1) //back adjacent core index
-								+ (sd - 1) * C * 2
-								+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number];
-
-							if (C == 3)
+							if (c == C_Heter)
 							{
-								if (c == C_Heter)
+								if (Omega_r1 == N)
 								{
-									if (Omega_r1 == N)
-									{
-										mod.add(IloIfThen(env,
-											same_core_con1 == 2, spectrum_consistency_con2 == 1));
+									mod.add(IloIfThen(env,
+										same_core_con1 == 2, spectrum_consistency_con2 == 1));
 
-										mod.add(IloIfThen(env,
-											same_core_con2 == 2, spectrum_consistency_con2 == 1));
-									}
-								}
-								else
-								{
-									if (Omega_r1 != N)
-									{
-										mod.add(IloIfThen(env,
-											(same_core_con1 == 2) +
-											(x[2 * (c - 1)
-												+ (sd - 1) * C * 2
-												+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-												x[2 * ((((c + C) % C + 1) == C_Heter ? (C_Heter + C) % C + 1 : (c + C) % C + 1) - 1) //font adjacent core index equals to the back
-												+ (sd - 1) * C * 2
-												+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number] == 2) == 1,
-											spectrum_consistency_con1 == 1));
-
-										mod.add(IloIfThen(env,
-											(same_core_con2 == 2) +
-											(x[(2 * c - 1)
-												+ (sd - 1) * C * 2
-												+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
-												x[(2 * (((c + C) % C + 1) == C_Heter ? (C_Heter + C) % C + 1 : (c + C) % C + 1) - 1) //font adjacent core index equals to the back
-												+ (sd - 1) * C * 2
-												+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number] == 2) == 1,
-											spectrum_consistency_con1 == 1));
-									}
+									mod.add(IloIfThen(env,
+										same_core_con2 == 2, spectrum_consistency_con2 == 1));
 								}
 							}
 							else
 							{
-								if (c == C_Heter)
+								if (Omega_r1 != N)
 								{
-									if (Omega_r1 == N)
+									//The hetergeneous core suffers no cross-talk, so only the other adjacent cores are counted:
+									IloExpr	adjacent_core_con1(env), adjacent_core_con2(env);
+									adjacent_core_con1 += (same_core_con1 == 2);
+									adjacent_core_con2 += (same_core_con2 == 2);
+									for (VONELayout::Core_Mask mask = Layout.crosstalk_mask(c, C_Heter); mask != 0; mask &= mask - 1)
 									{
-										mod.add(IloIfThen(env,
-											same_core_con1 == 2, spectrum_consistency_con2 == 1));
-
-										mod.add(IloIfThen(env,
-											same_core_con2 == 2, spectrum_consistency_con2 == 1));
-									}
-								}
-								else
-								{
-									if (Omega_r1 != N)
-									{
-										if (((c + C - 2) % C + 1) == C_Heter)
-										{
-											mod.add(IloIfThen(env,
-												(same_core_con1 == 2) + (font_adjacent_core_con1 == 2) == 1, spectrum_consistency_con1 == 1));
-
-											mod.add(IloIfThen(env,
-												(same_core_con2 == 2) + (font_adjacent_core_con2 == 2) == 1, spectrum_consistency_con1 == 1));
-										}
-										else if (((c + C) % C + 1) == C_Heter)
-										{
-											mod.add(IloIfThen(env,
-												(same_core_con1 == 2) + (back_adjacent_core_con1 == 2) == 1, spectrum_consistency_con1 == 1));
-
-											mod.add(IloIfThen(env,
-												(same_core_con2 == 2) + (back_adjacent_core_con2 == 2) == 1, spectrum_consistency_con1 == 1));
-										}
-										else
-										{
-											mod.add(IloIfThen(env,
-												(font_adjacent_core_con1 == 2) +
-												(same_core_con1 == 2) +
-												(back_adjacent_core_con1 == 2) == 1, spectrum_consistency_con1 == 1));
-
-											mod.add(IloIfThen(env,
-												(font_adjacent_core_con2 == 2) +
-												(same_core_con2 == 2) +
-												(back_adjacent_core_con2 == 2) == 1, spectrum_consistency_con1 == 1));
-										}
+										int adjacent_core = VONELayout::Lowest_Core(mask);
+
+										adjacent_core_con1 += (x[2 * (c - 1)
+											+ (sd - 1) * C * 2
+											+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
+											x[2 * (adjacent_core - 1)
+											+ (sd - 1) * C * 2
+											+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number] == 2);
+
+										adjacent_core_con2 += (x[(2 * c - 1)
+											+ (sd - 1) * C * 2
+											+ (r1 - 1) * C * 2 * Substrate_Network_Edge_Number] +
+											x[(2 * adjacent_core - 1)
+											+ (sd - 1) * C * 2
+											+ (r2 - 1) * C * 2 * Substrate_Network_Edge_Number] == 2);
 									}
+
+									mod.add(IloIfThen(env,
+										adjacent_core_con1 == 1, spectrum_consistency_con1 == 1));
+
+									mod.add(IloIfThen(env,
+										adjacent_core_con2 == 1, spectrum_consistency_con1 == 1));
 								}
 							}
 						}
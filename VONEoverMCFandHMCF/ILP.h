@@ -9,6 +9,7 @@
 #pragma once
 #include <ilcplex/ilocplex.h>
 #include "Topo.h"
+#include "Layout.h"
 ILOSTLBEGIN
 
 namespace VONEILP
@@ -23,7 +24,13 @@ namespace VONEILP
 			int CoreNumber, int HeterogeneousCoreIndex, string CrosstalkYesorNo);
 		//Precondition: Topologies of substrate netwrok and virtual networks have been assigned, CoreNumber, HeterogeneousCoreIndex,
 		//	and CrosstalkYesorNo have been initialized
-		//Postcondition: Solve the integer linear programming of VONE based on the Substrate_Network and Virtual_Network_List
+		//Postcondition: Solve the integer linear programming of VONE based on the Substrate_Network and Virtual_Network_List with CoreNumber cores in a ring
+
+		void solve(const VONETopo::Topo& Substrate_Network, const vector<VONETopo::Topo>& Virtual_Network_List, 
+			const VONELayout::Core_Layout& Layout, int HeterogeneousCoreIndex, string CrosstalkYesorNo);
+		//Precondition: Topologies of substrate netwrok and virtual networks have been assigned, Layout, HeterogeneousCoreIndex,
+		//	and CrosstalkYesorNo have been initialized
+		//Postcondition: Solve the integer linear programming of VONE based on the Substrate_Network and Virtual_Network_List with the cores arranged as Layout
 
 		friend ostream& operator <<(ostream& outs, VONECplex& VONEILP);
 		//Precondition: outs has been connected to an out stream
@@ -0,0 +1,220 @@
+//This file defines class core layout.
+//------------------------------------------------
+//File Name: Layout.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Layout.h"
+
+#include <cstdlib>
+#include <queue>
+
+namespace
+{
+	void Check_Core_Num(const int Core_Num);
+	//Postcondition: The program exits when Core_Num is out of 1 to Max_Core_Num
+
+	void Hexagonal_Cell(const int Core_Num, vector<pair<int, int> >& Cell);
+	//Precondition: Core_Num >= 1
+	//Postcondition: The axial coordinates of the first Core_Num cells of the hexagonal lattice have been put into Cell,
+	//    the center first and then ring by ring
+
+	int Hexagonal_Distance(const pair<int, int>& Cell1, const pair<int, int>& Cell2);
+	//Postcondition: Return the number of hops between the cells in the axial coordinates
+}
+
+namespace VONELayout
+{
+	Core_Layout::Core_Layout() : _core_num(0)
+	{
+
+	}
+
+	Core_Layout::Core_Layout(const int Core_Num, const string& Layout_Type) : _core_num(Core_Num)
+	{
+		Check_Core_Num(Core_Num);
+		_neighbour.assign(Core_Num, 0);
+
+		if (Layout_Type == "Ring")
+		{
+			for (int c = 1; c <= Core_Num; c++)
+			{
+				if (c % Core_Num + 1 != c)
+					add_adjacency(c, c % Core_Num + 1);
+			}
+		}
+		else if (Layout_Type == "Hexagonal")
+		{
+			vector<pair<int, int> > cell;
+			Hexagonal_Cell(Core_Num, cell);
+			for (int c1 = 1; c1 <= Core_Num; c1++)
+			{
+				for (int c2 = c1 + 1; c2 <= Core_Num; c2++)
+				{
+					if (Hexagonal_Distance(cell[c1 - 1], cell[c2 - 1]) == 1)
+						add_adjacency(c1, c2);
+				}
+			}
+		}
+		else if (Layout_Type == "Linear")
+		{
+			for (int c = 1; c < Core_Num; c++)
+				add_adjacency(c, c + 1);
+		}
+		else
+		{
+			cerr << "Wrong core layout, right layout should be Ring, Hexagonal or Linear!\n";
+			exit(1);
+		}
+
+		compute_distance();
+	}
+
+	istream& operator >>(istream& ins, Core_Layout& Layout)
+	{
+		int Core_Num;
+		if (!(ins >> Core_Num))
+		{
+			cerr << "Core layout input has no number of cores.\n";
+			exit(1);
+		}
+		Check_Core_Num(Core_Num);
+		Layout._core_num = Core_Num;
+		Layout._neighbour.assign(Core_Num, 0);
+
+		int Core1, Core2;
+		while (ins >> Core1 >> Core2)
+		{
+			if (Core1 < 1 || Core1 > Core_Num || Core2 < 1 || Core2 > Core_Num || Core1 == Core2)
+			{
+				cerr << "Wrong adjacent cores " << Core1 << " and " << Core2 << " in core layout input.\n";
+				exit(1);
+			}
+			Layout.add_adjacency(Core1, Core2);
+		}
+		Layout.compute_distance();
+
+		return ins;
+	}
+
+	Core_Mask Core_Layout::neighbour_mask(const int Core) const
+	{
+		return _neighbour[Core - 1];
+	}
+
+	Core_Mask Core_Layout::crosstalk_mask(const int Core, const int Hetergeneous_Core) const
+	{
+		if (Core == Hetergeneous_Core)
+			return 0;
+		return _neighbour[Core - 1] & ~Core_Bit(Hetergeneous_Core);
+	}
+
+	bool Core_Layout::adjacent(const int Core1, const int Core2) const
+	{
+		return (_neighbour[Core1 - 1] & Core_Bit(Core2)) != 0;
+	}
+
+	int Core_Layout::distance(const int Core1, const int Core2) const
+	{
+		return _distance[(Core1 - 1) * _core_num + Core2 - 1];
+	}
+
+	int Core_Layout::get_core_num() const
+	{
+		return _core_num;
+	}
+
+	Core_Layout::~Core_Layout()
+	{
+
+	}
+
+	void Core_Layout::add_adjacency(const int Core1, const int Core2)
+	{
+		_neighbour[Core1 - 1] |= Core_Bit(Core2);
+		_neighbour[Core2 - 1] |= Core_Bit(Core1);
+	}
+
+	void Core_Layout::compute_distance()
+	{
+		//Breadth first search from each core over the neighbour masks:
+		_distance.assign(_core_num * _core_num, _core_num);
+		for (int source = 1; source <= _core_num; source++)
+		{
+			int* row = &_distance[(source - 1) * _core_num];
+			row[source - 1] = 0;
+			queue<int> frontier;
+			frontier.push(source);
+			while (!frontier.empty())
+			{
+				int core = frontier.front();
+				frontier.pop();
+				for (Core_Mask mask = _neighbour[core - 1]; mask != 0; mask &= mask - 1)
+				{
+					int neighbour = Lowest_Core(mask);
+					if (row[neighbour - 1] == _core_num && neighbour != source)
+					{
+						row[neighbour - 1] = row[core - 1] + 1;
+						frontier.push(neighbour);
+					}
+				}
+			}
+		}
+	}
+
+	Core_Mask Core_Bit(const int Core)
+	{
+		return Core == 0 ? 0 : 1ULL << (Core - 1);
+	}
+
+	int Lowest_Core(const Core_Mask Mask)
+	{
+		int core = 1;
+		while ((Mask & Core_Bit(core)) == 0)
+			core++;
+		return core;
+	}
+}
+
+namespace
+{
+	void Check_Core_Num(const int Core_Num)
+	{
+		if (Core_Num < 1 || Core_Num > VONELayout::Max_Core_Num)
+		{
+			cerr << "Number of cores should be from 1 to " << VONELayout::Max_Core_Num << "!\n";
+			exit(1);
+		}
+	}
+
+	void Hexagonal_Cell(const int Core_Num, vector<pair<int, int> >& Cell)
+	{
+		const int Direction[6][2] = { { 1, 0 }, { 1, -1 }, { 0, -1 }, { -1, 0 }, { -1, 1 }, { 0, 1 } };
+
+		Cell.clear();
+		Cell.push_back(make_pair(0, 0));
+		for (int ring = 1; static_cast<int>(Cell.size()) < Core_Num; ring++)
+		{
+			//Walk around the ring from its corner in the fifth direction:
+			pair<int, int> cell(Direction[4][0] * ring, Direction[4][1] * ring);
+			for (int side = 0; side < 6; side++)
+			{
+				for (int step = 0; step < ring; step++)
+				{
+					if (static_cast<int>(Cell.size()) < Core_Num)
+						Cell.push_back(cell);
+					cell.first += Direction[side][0];
+					cell.second += Direction[side][1];
+				}
+			}
+		}
+	}
+
+	int Hexagonal_Distance(const pair<int, int>& Cell1, const pair<int, int>& Cell2)
+	{
+		int dq = Cell1.first - Cell2.first, dr = Cell1.second - Cell2.second;
+		return (abs(dq) + abs(dr) + abs(dq + dr)) / 2;
+	}
+}
@@ -0,0 +1,81 @@
+//This file declares class core layout.
+//------------------------------------------------
+//File Name: Layout.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+namespace VONELayout
+{
+	typedef unsigned long long Core_Mask;
+	const int Max_Core_Num = 64;
+
+	//The arrangement of the cores in a fiber, where the bit (Core - 1) of a mask stands for the core Core.
+	//    The neighbours of each core and the hop distances between the cores are computed once,
+	//    so that checking the adjacent cores is a mask intersection
+	class Core_Layout
+	{
+	public:
+		Core_Layout();
+
+		Core_Layout(const int Core_Num, const string& Layout_Type = "Ring");
+		//Precondition: 1 <= Core_Num <= Max_Core_Num, and Layout_Type is one of "Ring", "Hexagonal" or "Linear"
+		//Postcondition: The cores are arranged as Layout_Type, where "Ring" puts the core Core between Core - 1 and Core + 1 cyclically,
+		//    "Hexagonal" puts the core 1 in the center and the others ring by ring around it as the 7-core and 19-core fibers,
+		//    and "Linear" puts the cores in a row
+
+		friend istream& operator >>(istream& ins, Core_Layout& Layout);
+		//Precondition: ins has been connected to an in stream, which gives the number of cores followed by the adjacent core pairs
+		//Postcondition: Layout has been built from ins
+
+		Core_Mask neighbour_mask(const int Core) const;
+		//Precondition: 1 <= Core <= _core_num
+		//Postcondition: Return the mask of the cores adjacent to Core
+
+		Core_Mask crosstalk_mask(const int Core, const int Hetergeneous_Core) const;
+		//Precondition: 1 <= Core <= _core_num, and Hetergeneous_Core is the heterogeneous core or 0
+		//Postcondition: Return the mask of the cores adjacent to Core which suffer the crosstalk with Core,
+		//    the heterogeneous core suffers no crosstalk
+
+		bool adjacent(const int Core1, const int Core2) const;
+		//Precondition: 1 <= Core1, Core2 <= _core_num
+		//Postcondition: Return whether Core1 and Core2 are adjacent
+
+		int distance(const int Core1, const int Core2) const;
+		//Precondition: 1 <= Core1, Core2 <= _core_num
+		//Postcondition: Return the number of hops between Core1 and Core2, or _core_num if they are not connected
+
+		int get_core_num() const;
+		//Postcondition: Return the number of cores _core_num
+
+		~Core_Layout();
+
+	private:
+		void add_adjacency(const int Core1, const int Core2);
+		//Precondition: 1 <= Core1, Core2 <= _core_num and Core1 != Core2
+		//Postcondition: Core1 and Core2 have been marked adjacent to each other
+
+		void compute_distance();
+		//Postcondition: The hop distances between all cores have been computed into _distance
+
+		int _core_num;
+		vector<Core_Mask> _neighbour;
+		vector<int> _distance;		//_distance[(Core1 - 1) * _core_num + Core2 - 1]
+	};
+
+	Core_Mask Core_Bit(const int Core);
+	//Precondition: 0 <= Core <= Max_Core_Num
+	//Postcondition: Return the mask of the core Core, which is 0 when Core is 0
+
+	int Lowest_Core(const Core_Mask Mask);
+	//Precondition: Mask is not 0
+	//Postcondition: Return the smallest core in Mask
+}
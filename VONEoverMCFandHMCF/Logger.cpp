@@ -0,0 +1,177 @@
+//This file defines class log ring buffer, log stream buffer and logger.
+//------------------------------------------------
+//File Name: Logger.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	bool Is_Power_of_Two(const size_t Number);
+	//Postcondition: Return whether Number is a power of 2
+}
+
+namespace VONELog
+{
+	Log_Ring::Log_Ring(const size_t Capacity) : _data(Capacity), _mask(Capacity - 1), _head(0), _tail(0)
+	{
+		if (!Is_Power_of_Two(Capacity))
+		{
+			cerr << "Capacity of the log ring should be a power of 2!\n";
+			exit(1);
+		}
+	}
+
+	size_t Log_Ring::write(const char* Data, const size_t Size)
+	{
+		size_t head = _head.load(memory_order_relaxed);
+		size_t tail = _tail.load(memory_order_acquire);
+		size_t num = min(Size, _data.size() - (head - tail));
+
+		//The bytes may wrap around the end of the ring:
+		size_t offset = head & _mask;
+		size_t first = min(num, _data.size() - offset);
+		memcpy(_data.data() + offset, Data, first);
+		memcpy(_data.data(), Data + first, num - first);
+
+		_head.store(head + num, memory_order_release);
+		return num;
+	}
+
+	size_t Log_Ring::read(char* Data, const size_t Size)
+	{
+		size_t tail = _tail.load(memory_order_relaxed);
+		size_t head = _head.load(memory_order_acquire);
+		size_t num = min(Size, head - tail);
+
+		size_t offset = tail & _mask;
+		size_t first = min(num, _data.size() - offset);
+		memcpy(Data, _data.data() + offset, first);
+		memcpy(Data + first, _data.data(), num - first);
+
+		_tail.store(tail + num, memory_order_release);
+		return num;
+	}
+
+	Log_Buffer::Log_Buffer(Log_Ring& Ring) : _ring(Ring)
+	{
+		setp(_local, _local + sizeof(_local));
+	}
+
+	Log_Buffer::int_type Log_Buffer::overflow(int_type Character)
+	{
+		push();
+		if (!traits_type::eq_int_type(Character, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(Character);
+			pbump(1);
+		}
+		return traits_type::not_eof(Character);
+	}
+
+	int Log_Buffer::sync()
+	{
+		push();
+		return 0;
+	}
+
+	void Log_Buffer::push()
+	{
+		const char* data = pbase();
+		size_t size = pptr() - pbase();
+		while (size > 0)
+		{
+			size_t num = _ring.write(data, size);
+			data += num;
+			size -= num;
+			if (num == 0)
+				this_thread::yield();
+		}
+		setp(_local, _local + sizeof(_local));
+	}
+
+	Logger::Logger() : _level(Log_Off), _has_file(false), _ring(1), _buffer(_ring), _stream(&_buffer), _stop(false)
+	{
+
+	}
+
+	Logger::Logger(const string& File_Name, const Log_Level Level, const size_t Capacity)
+		: _level(min(static_cast<int>(Level), VONE_LOG_MAX_LEVEL)), _has_file(_level != Log_Off), _ring(Capacity), _buffer(_ring), _stream(&_buffer), _stop(false)
+	{
+		if (!_has_file)
+			return;
+
+		_file.open(File_Name.c_str());
+		if (_file.fail())
+		{
+			cerr << "File " << File_Name << " opening failed.\n";
+			exit(1);
+		}
+		_drainer = thread(&Logger::drain, this);
+	}
+
+	void Logger::set_level(const Log_Level Level)
+	{
+		if (_has_file)
+			_level.store(min(static_cast<int>(Level), VONE_LOG_MAX_LEVEL), memory_order_relaxed);
+	}
+
+	Log_Level Logger::get_level() const
+	{
+		return static_cast<Log_Level>(_level.load(memory_order_relaxed));
+	}
+
+	bool Logger::enabled(const Log_Level Level) const
+	{
+		return Level != Log_Off && Level <= _level.load(memory_order_relaxed);
+	}
+
+	ostream& Logger::stream()
+	{
+		return _stream;
+	}
+
+	Logger::~Logger()
+	{
+		if (!_has_file)
+			return;
+
+		_stream.flush();
+		_stop.store(true, memory_order_release);
+		_drainer.join();
+		_file.close();
+	}
+
+	void Logger::drain()
+	{
+		vector<char> chunk(64 * 1024);
+		while (true)
+		{
+			//The stop flag is read before the ring, so the bytes pushed before the logger is destroyed are all drained:
+			bool stop = _stop.load(memory_order_acquire);
+			size_t num = _ring.read(chunk.data(), chunk.size());
+			if (num > 0)
+				_file.write(chunk.data(), num);
+			else if (stop)
+				break;
+			else
+				this_thread::sleep_for(chrono::microseconds(200));
+		}
+	}
+}
+
+namespace
+{
+	bool Is_Power_of_Two(const size_t Number)
+	{
+		return Number != 0 && (Number & (Number - 1)) == 0;
+	}
+}
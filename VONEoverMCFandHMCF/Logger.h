@@ -0,0 +1,134 @@
+//This file declares class log ring buffer, log stream buffer and logger, and the macros to write the leveled records.
+//------------------------------------------------
+//File Name: Logger.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+
+using namespace std;
+
+//The highest level compiled in, the records above it are removed by the compiler together with their formatting.
+//    Define it as 0 to compile all logging out, or as 1 to keep only the setup and the blocked virtual networks
+#ifndef VONE_LOG_MAX_LEVEL
+#define VONE_LOG_MAX_LEVEL 3
+#endif
+
+//Whether the records of Level are written into Log, used to skip a whole block of records at once
+#define VONE_LOG_ON(Log, Level) ((Level) <= VONE_LOG_MAX_LEVEL && (Log).enabled(Level))
+
+//The stream of Log when the records of Level are written, otherwise the statement is skipped before its operands are evaluated
+#define VONE_LOG(Log, Level) if (!VONE_LOG_ON(Log, Level)) ; else (Log).stream()
+
+namespace VONELog
+{
+	//The verbosity of the log, each level includes the records of the lower ones
+	enum Log_Level
+	{
+		Log_Off,
+		Log_Info,		//The Core Priority, the Core Classification and the virtual networks blocked
+		Log_Debug,		//The result of each embedding step of each virtual network
+		Log_Trace		//The sorted virtual networks and the core records of the core assignment
+	};
+
+	//The single producer single consumer ring of the formatted bytes, where the producer and the consumer
+	//    only publish their own counter, so neither of them waits for a lock
+	class Log_Ring
+	{
+	public:
+		Log_Ring(const size_t Capacity);
+		//Precondition: Capacity is a power of 2
+		//Postcondition: The ring is empty and holds at most Capacity bytes
+
+		size_t write(const char* Data, const size_t Size);
+		//Precondition: Only the producer calls write
+		//Postcondition: Return the number of the bytes copied from Data into the ring, which is less than Size when the ring is full
+
+		size_t read(char* Data, const size_t Size);
+		//Precondition: Only the consumer calls read
+		//Postcondition: Return the number of the bytes moved from the ring into Data, at most Size
+
+	private:
+		vector<char> _data;
+		size_t _mask;
+		atomic<size_t> _head;		//The bytes written since the beginning
+		atomic<size_t> _tail;		//The bytes read since the beginning
+	};
+
+	//The stream buffer which formats the records in a local buffer and moves them into the ring
+	//    when it is full or flushed, waiting only when the consumer falls a whole ring behind
+	class Log_Buffer : public streambuf
+	{
+	public:
+		Log_Buffer(Log_Ring& Ring);
+		//Postcondition: The formatted bytes are moved into Ring
+
+	protected:
+		int_type overflow(int_type Character);
+		int sync();
+
+	private:
+		void push();
+		//Postcondition: The bytes in the local buffer have been moved into the ring
+
+		Log_Ring& _ring;
+		char _local[4096];
+	};
+
+	//Create the logger, which writes the records up to the level set at runtime into a file.
+	//    The records are formatted by the calling thread into the ring, and a background thread drains the ring into the file,
+	//    so the calling thread never waits for the file. Only one thread may write the records of a logger
+	class Logger
+	{
+	public:
+		Logger();
+		//Postcondition: The logger has no file and writes nothing at any level
+
+		Logger(const string& File_Name, const Log_Level Level, const size_t Capacity = 1 << 20);
+		//Precondition: Capacity is a power of 2
+		//Postcondition: The records up to Level, and not above VONE_LOG_MAX_LEVEL, are written into the file File_Name through a ring of Capacity bytes.
+		//    The file is not opened when no level is left
+
+		void set_level(const Log_Level Level);
+		//Postcondition: The records up to Level are written from now on, which is ignored when the logger has no file
+
+		Log_Level get_level() const;
+		//Postcondition: Return the level of the logger
+
+		bool enabled(const Log_Level Level) const;
+		//Postcondition: Return whether the records of Level are written
+
+		ostream& stream();
+		//Precondition: enabled is true for the level of the record
+		//Postcondition: Return the stream which formats the records into the ring
+
+		~Logger();
+		//Postcondition: All records have been written into the file, and the background thread has been joined
+
+	private:
+		Logger(const Logger&);
+		Logger& operator =(const Logger&);
+
+		void drain();
+		//Postcondition: The ring has been drained into the file until the logger is destroyed
+
+		atomic<int> _level;
+		bool _has_file;
+		Log_Ring _ring;
+		Log_Buffer _buffer;
+		ostream _stream;
+		ofstream _file;
+		atomic<bool> _stop;
+		thread _drainer;
+	};
+}
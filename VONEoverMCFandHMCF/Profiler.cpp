@@ -0,0 +1,118 @@
+//This file defines class scoped timer and the counters of the embedding pipeline.
+//------------------------------------------------
+//File Name: Profiler.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Profiler.h"
+
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	//The totals of one thread, which are only written by that thread
+	struct Profile_Block
+	{
+		long long _time[VONEProfile::Phase_Num];		//In nanoseconds
+		long long _call[VONEProfile::Phase_Num];
+		long long _count[VONEProfile::Counter_Num];
+	};
+
+	const char* const Phase_Name[VONEProfile::Phase_Num] =
+		{ "Vertexes Embedding", "Edges Embedding", "Core Assignment", "Frequency Recovery", "Frequency Allocating" };
+	const char* const Counter_Name[VONEProfile::Counter_Num] =
+		{ "Dijkstra calls", "Start slot trials", "Rollbacks", "Hops scanned" };
+
+	//The blocks of all threads, kept after the threads have ended so that their totals are still reported
+	mutex Block_Mutex;
+	vector<unique_ptr<Profile_Block> > Block_List;
+
+	Profile_Block& Local_Block();
+	//Postcondition: Return the block of the calling thread, which has been cleared and registered on its first use
+}
+
+namespace VONEProfile
+{
+	Scoped_Timer::Scoped_Timer(const Profile_Phase Phase) : _phase(Phase), _start(chrono::steady_clock::now())
+	{
+
+	}
+
+	Scoped_Timer::~Scoped_Timer()
+	{
+		Profile_Block& block = Local_Block();
+		block._time[_phase] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - _start).count();
+		block._call[_phase]++;
+	}
+
+	void Count(const Profile_Counter Counter, const long long Number)
+	{
+		Local_Block()._count[Counter] += Number;
+	}
+
+	void Report(ostream& outs)
+	{
+		Profile_Block total = {};
+		{
+			lock_guard<mutex> lock(Block_Mutex);
+			for (vector<unique_ptr<Profile_Block> >::const_iterator iter = Block_List.begin(); iter != Block_List.end(); iter++)
+			{
+				for (int phase = 0; phase < Phase_Num; phase++)
+				{
+					total._time[phase] += (*iter)->_time[phase];
+					total._call[phase] += (*iter)->_call[phase];
+				}
+				for (int counter = 0; counter < Counter_Num; counter++)
+					total._count[counter] += (*iter)->_count[counter];
+			}
+		}
+
+		long long total_time = 0;
+		for (int phase = 0; phase < Phase_Num; phase++)
+			total_time += total._time[phase];
+
+		ios::fmtflags flags = outs.flags();
+		streamsize precision = outs.precision();
+		outs << fixed << setprecision(3);
+		outs << "Profile of the embedding phases:\n";
+		outs << left << setw(24) << "Phase" << right << setw(12) << "Calls" << setw(14) << "Time(ms)" << setw(10) << "Share(%)" << "\n";
+		for (int phase = 0; phase < Phase_Num; phase++)
+		{
+			outs << left << setw(24) << Phase_Name[phase] << right << setw(12) << total._call[phase]
+				<< setw(14) << total._time[phase] / 1e6 << setw(10) << (total_time == 0 ? 0.0 : 100.0 * total._time[phase] / total_time) << "\n";
+		}
+		outs << "Counters of the embedding phases:\n";
+		for (int counter = 0; counter < Counter_Num; counter++)
+			outs << left << setw(24) << Counter_Name[counter] << right << setw(12) << total._count[counter] << "\n";
+		outs << "\n";
+		outs.flags(flags);
+		outs.precision(precision);
+	}
+
+	void Reset()
+	{
+		lock_guard<mutex> lock(Block_Mutex);
+		for (vector<unique_ptr<Profile_Block> >::iterator iter = Block_List.begin(); iter != Block_List.end(); iter++)
+			**iter = Profile_Block();
+	}
+}
+
+namespace
+{
+	Profile_Block& Local_Block()
+	{
+		thread_local Profile_Block* block = NULL;
+		if (block == NULL)
+		{
+			lock_guard<mutex> lock(Block_Mutex);
+			Block_List.push_back(unique_ptr<Profile_Block>(new Profile_Block()));
+			block = Block_List.back().get();
+		}
+		return *block;
+	}
+}
@@ -0,0 +1,86 @@
+//This file declares class scoped timer, the counters of the embedding pipeline, and the macros to instrument it.
+//------------------------------------------------
+//File Name: Profiler.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+//Define VONE_PROFILE to compile the phase timers and the counters in. They are left out by default,
+//    so that a release build does not pay for them, and the macros below then expand to nothing
+#ifdef VONE_PROFILE
+
+//Time the rest of the enclosing block as Phase, at most once per block
+#define VONE_PROFILE_SCOPE(Phase) VONEProfile::Scoped_Timer VONE_Profile_Timer(Phase)
+
+//Add Number to Counter
+#define VONE_PROFILE_COUNT(Counter, Number) VONEProfile::Count(Counter, Number)
+
+#else
+
+#define VONE_PROFILE_SCOPE(Phase) ((void)0)
+#define VONE_PROFILE_COUNT(Counter, Number) ((void)0)
+
+#endif
+
+namespace VONEProfile
+{
+	//The phases of the embedding pipeline, timed by wall clock
+	enum Profile_Phase
+	{
+		Phase_Vertexes_Embedding,
+		Phase_Edges_Embedding,
+		Phase_Core_Assignment,
+		Phase_Frequency_Recovery,		//The frequency slots returned by release
+		Phase_Frequency_Allocating,
+		Phase_Num
+	};
+
+	//The events counted inside the phases
+	enum Profile_Counter
+	{
+		Counter_Dijkstra_Call,			//Each shortest path search, including those of the K shortest paths
+		Counter_Start_Slot_Trial,		//Each start frequency slot tried on a whole path by the core assignment
+		Counter_Rollback,				//Each start frequency slot given up by the core assignment on a later hop, 
+										//    and each reservation given back by the concurrent embedding on a conflict
+		Counter_Hop_Scanned,			//Each hop checked for a free core at a start frequency slot
+		Counter_Num
+	};
+
+	//Create the timer, which adds the wall-clock time from its construction to its destruction to its phase.
+	//    Each thread adds to its own totals, so the timers and the counters never wait for each other
+	class Scoped_Timer
+	{
+	public:
+		Scoped_Timer(const Profile_Phase Phase);
+		//Postcondition: The timer has started for Phase
+
+		~Scoped_Timer();
+		//Postcondition: The time since the construction and one call have been added to the phase
+
+	private:
+		Scoped_Timer(const Scoped_Timer&);
+		Scoped_Timer& operator =(const Scoped_Timer&);
+
+		Profile_Phase _phase;
+		chrono::steady_clock::time_point _start;
+	};
+
+	void Count(const Profile_Counter Counter, const long long Number);
+	//Postcondition: Number has been added to Counter of the calling thread
+
+	void Report(ostream& outs);
+	//Precondition: No thread is timing or counting
+	//Postcondition: The calls and the time of each phase, with their share of the total, and the counters,
+	//    summed over all threads since the beginning or the last Reset, have been printed to outs
+
+	void Reset();
+	//Precondition: No thread is timing or counting
+	//Postcondition: The totals of all threads have been cleared
+}
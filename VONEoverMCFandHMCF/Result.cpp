@@ -0,0 +1,366 @@
+//This file defines class result sink and its CSV, JSON Lines and binary formats.
+//------------------------------------------------
+//File Name: Result.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Result.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	//The buffer is written into the file each time it grows beyond this size
+	const size_t Block_Size = 64 * 1024;
+
+	const char* Block_Name(const VONEHeuristic::Block_Reason Reason);
+	//Postcondition: Return the name of Reason written into the text formats
+}
+
+namespace VONEResult
+{
+	Result_Sink::Result_Sink(const string& File_Name, const bool Binary) : _spectrum_dump(false), _deferred(false)
+	{
+		_file.open(File_Name.c_str(), Binary ? ios::out | ios::binary : ios::out);
+		if (_file.fail())
+		{
+			cerr << "File " << File_Name << " opening failed.\n";
+			exit(1);
+		}
+		_buffer.reserve(2 * Block_Size);
+	}
+
+	void Result_Sink::set_spectrum_dump(const bool Dump)
+	{
+		_spectrum_dump = Dump;
+	}
+
+	void Result_Sink::set_deferred(const bool Deferred)
+	{
+		_deferred = Deferred;
+	}
+
+	void Result_Sink::write_summary(const int Request_Num, const int Block_Num, const VONESpectrum::Spectrum_Arena& Spectrum)
+	{
+		Result_Summary Summary = { Request_Num, Block_Num, 0, 0 };
+		for (int link = 0; link < Spectrum.get_link_num(); link++)
+		{
+			for (int core_index = 0; core_index < 2 * Spectrum.get_core_num(); core_index++)
+				Summary._max_slot_index = max(Summary._max_slot_index, Spectrum.highest_used_slot(link, core_index));
+			Summary._crosstalk += Spectrum.crosstalk(link);
+		}
+		write_summary_record(Summary);
+		if (_spectrum_dump)
+			write_spectrum(Spectrum);
+	}
+
+	void Result_Sink::flush()
+	{
+		_file.write(_buffer.data(), _buffer.size());
+		_file.flush();
+		_buffer.clear();
+	}
+
+	Result_Sink::~Result_Sink()
+	{
+		_file.write(_buffer.data(), _buffer.size());
+		_file.close();
+	}
+
+	void Result_Sink::append_text(const char* Text)
+	{
+		_buffer.append(Text);
+	}
+
+	void Result_Sink::append_number(const long long Number)
+	{
+		//The digits are filled from the end, which avoids the locale and the state of a stream:
+		char digit[24];
+		char* begin = digit + sizeof(digit);
+		unsigned long long magnitude = Number < 0 ? 0ULL - static_cast<unsigned long long>(Number) : static_cast<unsigned long long>(Number);
+		do
+		{
+			*--begin = static_cast<char>('0' + magnitude % 10);
+			magnitude /= 10;
+		} while (magnitude != 0);
+		if (Number < 0)
+			*--begin = '-';
+		_buffer.append(begin, digit + sizeof(digit));
+	}
+
+	void Result_Sink::append_raw(const void* Data, const size_t Size)
+	{
+		_buffer.append(static_cast<const char*>(Data), Size);
+	}
+
+	void Result_Sink::commit()
+	{
+		if (!_deferred && _buffer.size() >= Block_Size)
+		{
+			_file.write(_buffer.data(), _buffer.size());
+			_buffer.clear();
+		}
+	}
+
+	CSV_Sink::CSV_Sink(const string& File_Name) : Result_Sink(File_Name, false)
+	{
+		append_text("request,handle,blocked,service_type,start_frequency,width,vertex,path,core\n");
+	}
+
+	void CSV_Sink::write_request(const int Request, const VONEHeuristic::Embedding_Result& Result)
+	{
+		append_number(Request);
+		append_text(",");
+		append_number(Result._handle);
+		append_text(",");
+		append_text(Block_Name(Result._block_reason));
+		append_text(",");
+		append_number(Result._service_type);
+		append_text(",");
+		append_number(Result._start_frequency);
+		append_text(",");
+		append_number(Result._width);
+		append_text(",");
+		for (vector<int>::const_iterator iter = Result._vertex.begin(); iter != Result._vertex.end(); iter++)
+		{
+			if (iter != Result._vertex.begin())
+				append_text(" ");
+			append_number(*iter);
+		}
+		append_text(",");
+		//The nodes of each path are joined by -, leaving out the distance at the end:
+		for (vector<vector<int> >::const_iterator liter = Result._edge.begin(); liter != Result._edge.end(); liter++)
+		{
+			if (liter != Result._edge.begin())
+				append_text(" ");
+			for (vector<int>::const_iterator siter = liter->begin(); siter != prev(liter->end()); siter++)
+			{
+				if (siter != liter->begin())
+					append_text("-");
+				append_number(*siter);
+			}
+		}
+		append_text(",");
+		for (vector<int>::const_iterator iter = Result._core.begin(); iter != Result._core.end(); iter++)
+		{
+			if (iter != Result._core.begin())
+				append_text(" ");
+			append_number(*iter / 2 + 1);
+		}
+		append_text("\n");
+		commit();
+	}
+
+	void CSV_Sink::write_summary_record(const Result_Summary& Summary)
+	{
+		append_text("#summary,requests,");
+		append_number(Summary._request_num);
+		append_text(",blocked,");
+		append_number(Summary._block_num);
+		append_text(",max_slot_index,");
+		append_number(Summary._max_slot_index);
+		append_text(",crosstalk,");
+		append_number(Summary._crosstalk);
+		append_text("\n");
+		commit();
+	}
+
+	void CSV_Sink::write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum)
+	{
+		//One line per link, direction and core, holding the service type of each frequency slot as one digit:
+		string slot(Spectrum.get_slot_num(), '0');
+		for (int link = 0; link < Spectrum.get_link_num(); link++)
+		{
+			for (int core_index = 0; core_index < 2 * Spectrum.get_core_num(); core_index++)
+			{
+				const signed char* service_type = Spectrum.service_type(link, core_index);
+				for (int k = 0; k < Spectrum.get_slot_num(); k++)
+					slot[k] = static_cast<char>('0' + service_type[k]);
+
+				append_text("#spectrum,");
+				append_number(link + 1);
+				append_text(",");
+				append_number(core_index % 2);
+				append_text(",");
+				append_number(core_index / 2 + 1);
+				append_text(",");
+				append_text(slot.c_str());
+				append_text("\n");
+				commit();
+			}
+		}
+	}
+
+	JSON_Lines_Sink::JSON_Lines_Sink(const string& File_Name) : Result_Sink(File_Name, false)
+	{
+
+	}
+
+	void JSON_Lines_Sink::write_request(const int Request, const VONEHeuristic::Embedding_Result& Result)
+	{
+		append_text("{\"request\":");
+		append_number(Request);
+		append_text(",\"handle\":");
+		append_number(Result._handle);
+		append_text(",\"blocked\":\"");
+		append_text(Block_Name(Result._block_reason));
+		append_text("\",\"service_type\":");
+		append_number(Result._service_type);
+		append_text(",\"start_frequency\":");
+		append_number(Result._start_frequency);
+		append_text(",\"width\":");
+		append_number(Result._width);
+		append_text(",\"vertex\":[");
+		for (vector<int>::const_iterator iter = Result._vertex.begin(); iter != Result._vertex.end(); iter++)
+		{
+			if (iter != Result._vertex.begin())
+				append_text(",");
+			append_number(*iter);
+		}
+		append_text("],\"path\":[");
+		for (vector<vector<int> >::const_iterator liter = Result._edge.begin(); liter != Result._edge.end(); liter++)
+		{
+			if (liter != Result._edge.begin())
+				append_text(",");
+			append_text("{\"node\":[");
+			for (vector<int>::const_iterator siter = liter->begin(); siter != prev(liter->end()); siter++)
+			{
+				if (siter != liter->begin())
+					append_text(",");
+				append_number(*siter);
+			}
+			append_text("],\"distance\":");
+			append_number(liter->back());
+			append_text("}");
+		}
+		append_text("],\"core\":[");
+		for (vector<int>::const_iterator iter = Result._core.begin(); iter != Result._core.end(); iter++)
+		{
+			if (iter != Result._core.begin())
+				append_text(",");
+			append_number(*iter / 2 + 1);
+		}
+		append_text("]}\n");
+		commit();
+	}
+
+	void JSON_Lines_Sink::write_summary_record(const Result_Summary& Summary)
+	{
+		append_text("{\"summary\":{\"requests\":");
+		append_number(Summary._request_num);
+		append_text(",\"blocked\":");
+		append_number(Summary._block_num);
+		append_text(",\"max_slot_index\":");
+		append_number(Summary._max_slot_index);
+		append_text(",\"crosstalk\":");
+		append_number(Summary._crosstalk);
+		append_text("}}\n");
+		commit();
+	}
+
+	void JSON_Lines_Sink::write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum)
+	{
+		string slot(Spectrum.get_slot_num(), '0');
+		for (int link = 0; link < Spectrum.get_link_num(); link++)
+		{
+			for (int core_index = 0; core_index < 2 * Spectrum.get_core_num(); core_index++)
+			{
+				const signed char* service_type = Spectrum.service_type(link, core_index);
+				for (int k = 0; k < Spectrum.get_slot_num(); k++)
+					slot[k] = static_cast<char>('0' + service_type[k]);
+
+				append_text("{\"spectrum\":{\"link\":");
+				append_number(link + 1);
+				append_text(",\"direction\":");
+				append_number(core_index % 2);
+				append_text(",\"core\":");
+				append_number(core_index / 2 + 1);
+				append_text(",\"slot\":\"");
+				append_text(slot.c_str());
+				append_text("\"}}\n");
+				commit();
+			}
+		}
+	}
+
+	Binary_Sink::Binary_Sink(const string& File_Name) : Result_Sink(File_Name, true)
+	{
+		append_raw("VONR", 4);
+		append_int(1);
+	}
+
+	void Binary_Sink::write_request(const int Request, const VONEHeuristic::Embedding_Result& Result)
+	{
+		append_int(1);
+		append_int(Request);
+		append_int(Result._handle);
+		append_int(Result._block_reason);
+		append_int(Result._service_type);
+		append_int(Result._start_frequency);
+		append_int(Result._width);
+		append_int(static_cast<int>(Result._vertex.size()));
+		append_raw(Result._vertex.data(), Result._vertex.size() * sizeof(int));
+		append_int(static_cast<int>(Result._edge.size()));
+		for (vector<vector<int> >::const_iterator liter = Result._edge.begin(); liter != Result._edge.end(); liter++)
+		{
+			append_int(static_cast<int>(liter->size()) - 1);
+			append_raw(liter->data(), liter->size() * sizeof(int));
+		}
+		append_int(static_cast<int>(Result._core.size()));
+		append_raw(Result._core.data(), Result._core.size() * sizeof(int));
+		commit();
+	}
+
+	void Binary_Sink::write_summary_record(const Result_Summary& Summary)
+	{
+		append_int(2);
+		append_int(Summary._request_num);
+		append_int(Summary._block_num);
+		append_int(Summary._max_slot_index);
+		append_int(Summary._crosstalk);
+		commit();
+	}
+
+	void Binary_Sink::write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum)
+	{
+		append_int(3);
+		append_int(Spectrum.get_link_num());
+		append_int(Spectrum.get_core_num());
+		append_int(Spectrum.get_slot_num());
+		for (int link = 0; link < Spectrum.get_link_num(); link++)
+		{
+			for (int core_index = 0; core_index < 2 * Spectrum.get_core_num(); core_index++)
+			{
+				append_raw(Spectrum.service_type(link, core_index), Spectrum.get_slot_num());
+				commit();
+			}
+		}
+	}
+
+	void Binary_Sink::append_int(const int Number)
+	{
+		append_raw(&Number, sizeof(Number));
+	}
+}
+
+namespace
+{
+	const char* Block_Name(const VONEHeuristic::Block_Reason Reason)
+	{
+		switch (Reason)
+		{
+		case VONEHeuristic::Vertex_Blocked:
+			return "vertex";
+		case VONEHeuristic::Edge_Blocked:
+			return "edge";
+		case VONEHeuristic::Core_Blocked:
+			return "core";
+		default:
+			return "none";
+		}
+	}
+}
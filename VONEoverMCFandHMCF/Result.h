@@ -0,0 +1,133 @@
+//This file declares class result sink and its CSV, JSON Lines and binary formats.
+//------------------------------------------------
+//File Name: Result.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include "Heuristic.h"
+
+#include <fstream>
+#include <string>
+
+namespace VONEResult
+{
+	//The totals of a solve, written once after all its virtual networks
+	struct Result_Summary
+	{
+		int _request_num;
+		int _block_num;
+		int _max_slot_index;		//The Maximum Frequency Slot Index over all links, cores and directions
+		int _crosstalk;				//The Crosstalk summed over all links
+	};
+
+	//The sink which the per-VN records are streamed into as the virtual networks are embedded. The records are formatted
+	//    into a buffer which is written into the file in large blocks, so no record flushes the file by itself.
+	//    The frequency slots of every core are dumped only when set_spectrum_dump has been set, and nothing is written before flush
+	//    when set_deferred has been set
+	class Result_Sink
+	{
+	public:
+		Result_Sink(const string& File_Name, const bool Binary);
+		//Postcondition: The records are written into the file File_Name, which is opened in binary mode when Binary is true
+
+		void set_spectrum_dump(const bool Dump);
+		//Postcondition: write_summary dumps the service type of each frequency slot of each core when Dump is true,
+		//    which is false by default
+
+		void set_deferred(const bool Deferred);
+		//Postcondition: The records are kept in the buffer until flush or the destruction when Deferred is true, 
+		//    which is false by default, so that a timed solve does no file I/O
+
+		virtual void write_request(const int Request, const VONEHeuristic::Embedding_Result& Result) = 0;
+		//Precondition: Result has been returned for the Request-th virtual network, counted from 1
+		//Postcondition: The record of Result has been appended to the sink
+
+		void write_summary(const int Request_Num, const int Block_Num, const VONESpectrum::Spectrum_Arena& Spectrum);
+		//Precondition: Spectrum holds the substrate network after Request_Num virtual networks, of which Block_Num have been blocked
+		//Postcondition: The summary, and the spectrum dump when it has been set, have been appended to the sink
+
+		void flush();
+		//Postcondition: All records appended so far have been written into the file
+
+		virtual ~Result_Sink();
+		//Postcondition: All records have been written into the file, and the file has been closed
+
+	protected:
+		virtual void write_summary_record(const Result_Summary& Summary) = 0;
+		//Postcondition: The record of Summary has been appended to the sink
+
+		virtual void write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum) = 0;
+		//Postcondition: The service type of each frequency slot of each core of Spectrum has been appended to the sink
+
+		void append_text(const char* Text);
+		//Postcondition: Text without its terminating null has been appended to the buffer
+
+		void append_number(const long long Number);
+		//Postcondition: The decimal digits of Number have been appended to the buffer
+
+		void append_raw(const void* Data, const size_t Size);
+		//Postcondition: The Size bytes from Data have been appended to the buffer as they are
+
+		void commit();
+		//Postcondition: The buffer has been written into the file when it has grown beyond one block, unless it has been deferred
+
+	private:
+		ofstream _file;
+		string _buffer;
+		bool _spectrum_dump;
+		bool _deferred;
+	};
+
+	//One line of comma separated values per virtual network after a header line. The substrate nodes, the paths
+	//    and the cores are separated by spaces inside their columns, and the summary and the spectrum follow as lines beginning with #
+	class CSV_Sink : public Result_Sink
+	{
+	public:
+		CSV_Sink(const string& File_Name);
+		//Postcondition: The header line has been appended
+
+		void write_request(const int Request, const VONEHeuristic::Embedding_Result& Result);
+
+	protected:
+		void write_summary_record(const Result_Summary& Summary);
+		void write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum);
+	};
+
+	//One JSON object per line, holding either "request", "summary" or "spectrum"
+	class JSON_Lines_Sink : public Result_Sink
+	{
+	public:
+		JSON_Lines_Sink(const string& File_Name);
+
+		void write_request(const int Request, const VONEHeuristic::Embedding_Result& Result);
+
+	protected:
+		void write_summary_record(const Result_Summary& Summary);
+		void write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum);
+	};
+
+	//The records as 32-bit integers in the native byte order after the magic "VONR" and the version 1.
+	//    Each record begins with its tag: 1 for a request, followed by the request, the handle, the block reason, the service type,
+	//    the start frequency, the width, the vertex number and the substrate nodes, the path number and each path as its node number,
+	//    its nodes and its distance, and the hop number and the core indexes; 2 for the summary, followed by its four fields;
+	//    3 for the spectrum, followed by the link, core and slot numbers and the service type bytes of each link and core index in turn
+	class Binary_Sink : public Result_Sink
+	{
+	public:
+		Binary_Sink(const string& File_Name);
+		//Postcondition: The magic and the version have been appended
+
+		void write_request(const int Request, const VONEHeuristic::Embedding_Result& Result);
+
+	protected:
+		void write_summary_record(const Result_Summary& Summary);
+		void write_spectrum(const VONESpectrum::Spectrum_Arena& Spectrum);
+
+	private:
+		void append_int(const int Number);
+		//Postcondition: Number has been appended as 4 bytes in the native byte order
+	};
+}
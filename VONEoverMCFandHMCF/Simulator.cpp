@@ -0,0 +1,307 @@
+//This file defines class dynamic simulator.
+//------------------------------------------------
+//File Name: Simulator.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Simulator.h"
+
+#include <queue>
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+	//One entry of the event calendar, which is an arrival when _handle is -1 and otherwise the departure of the virtual network _handle
+	struct Event
+	{
+		double _time;
+		int _handle;
+	};
+
+	//The order of the event calendar, the earliest event is on the top
+	struct Event_Later
+	{
+		bool operator ()(const Event& EA, const Event& EB) const { return EA._time > EB._time; }
+	};
+
+	void Check_Run(const double Erlang_Load, const double Mean_Holding_Time, const long long Request_Num, const long long Warmup_Num);
+	//Postcondition: The program exits when the arguments of a run are out of range
+}
+
+namespace VONESimulator
+{
+	Dynamic_Simulator::Dynamic_Simulator(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout,
+		int HeterogeneousCoreIndex, string CrosstalkYesorNo, const unsigned int Seed)
+		: _substrate(Substrate_Network), _layout(Layout), _hetergeneous_core(HeterogeneousCoreIndex), _crosstalk(CrosstalkYesorNo), 
+		_defragmentation_budget(0), _path_candidate_num(0), _generator(Seed)
+	{
+
+	}
+
+	void Dynamic_Simulator::set_defragmentation(const double Time_Budget)
+	{
+		if (Time_Budget < 0)
+		{
+			cerr << "Time budget of the defragmentation should not be negative!\n";
+			exit(1);
+		}
+		_defragmentation_budget = Time_Budget;
+	}
+
+	void Dynamic_Simulator::set_path_candidate_num(const int K)
+	{
+		if (K < 0)
+		{
+			cerr << "Number of candidate paths should not be negative!\n";
+			exit(1);
+		}
+		_path_candidate_num = K;
+	}
+
+	void Dynamic_Simulator::run(const double Erlang_Load, const double Mean_Holding_Time, const long long Request_Num, const long long Warmup_Num)
+	{
+		Check_Run(Erlang_Load, Mean_Holding_Time, Request_Num, Warmup_Num);
+		_heuristic.set_path_candidate_num(_path_candidate_num);
+		_heuristic.prepare(_substrate, _layout, _hetergeneous_core, _crosstalk);
+
+		//The arrival rate is Erlang_Load / Mean_Holding_Time, so that the offered load is Erlang_Load:
+		exponential_distribution<double> Interarrival_Time(Erlang_Load / Mean_Holding_Time);
+		exponential_distribution<double> Holding_Time(1.0 / Mean_Holding_Time);
+
+		//At most one arrival is pending, so the calendar holds no more events than the embedded virtual networks plus one:
+		vector<Event> Calendar_Storage;
+		Calendar_Storage.reserve(1024);
+		priority_queue<Event, vector<Event>, Event_Later> Calendar(Event_Later(), Calendar_Storage);
+
+		Load_Result Result = { Erlang_Load, 0, 0, 0, 0, 0.0 };
+		long long Arrival = 0;
+		double Now = 0.0, Measure_Start = 0.0, Measure_End = 0.0, Active_Area = 0.0;
+		VONETopo::Topo Virtual_Network;
+
+		Event First_Arrival = { Interarrival_Time(_generator), -1 };
+		Calendar.push(First_Arrival);
+		while (!Calendar.empty())
+		{
+			Event Current = Calendar.top();
+			Calendar.pop();
+			Result._event_num++;
+
+			//The number of the embedded virtual networks is averaged from the first counted arrival to the last arrival:
+			if (Arrival > Warmup_Num && Arrival < Warmup_Num + Request_Num)
+				Active_Area += _heuristic.get_active_num() * (Current._time - Now);
+			Now = Current._time;
+
+			if (Current._handle != -1)
+			{
+				_heuristic.release(Current._handle);
+				continue;
+			}
+
+			Arrival++;
+			if (Arrival < Warmup_Num + Request_Num)
+			{
+				Event Next_Arrival = { Now + Interarrival_Time(_generator), -1 };
+				Calendar.push(Next_Arrival);
+			}
+			if (Arrival == Warmup_Num + 1)
+				Measure_Start = Now;
+			if (Arrival == Warmup_Num + Request_Num)
+				Measure_End = Now;
+
+			generate(Virtual_Network);
+			int Handle = admit(Virtual_Network, Result);
+			if (Arrival > Warmup_Num)
+			{
+				Result._arrival_num++;
+				if (Handle == -1)
+					Result._block_num++;
+			}
+			if (Handle != -1)
+			{
+				Event Departure = { Now + Holding_Time(_generator), Handle };
+				Calendar.push(Departure);
+			}
+		}
+
+		if (Measure_End > Measure_Start)
+			Result._average_active = Active_Area / (Measure_End - Measure_Start);
+		_result.push_back(Result);
+	}
+
+	void Dynamic_Simulator::run_trace(VONETrace::Trace_Reader& Reader, const long long Warmup_Num)
+	{
+		if (Warmup_Num < 0)
+		{
+			cerr << "Number of the warm-up requests should not be negative!\n";
+			exit(1);
+		}
+		_heuristic.set_path_candidate_num(_path_candidate_num);
+		_heuristic.prepare(_substrate, _layout, _hetergeneous_core, _crosstalk);
+
+		//Only the departures are kept in the event calendar, and the next arrival is the request read ahead from the trace:
+		vector<Event> Calendar_Storage;
+		Calendar_Storage.reserve(1024);
+		priority_queue<Event, vector<Event>, Event_Later> Calendar(Event_Later(), Calendar_Storage);
+
+		Load_Result Result = { 0.0, 0, 0, 0, 0, 0.0 };
+		long long Arrival = 0;
+		double Now = 0.0, Measure_Start = 0.0, Measure_End = 0.0, Active_Area = 0.0, Holding_Area = 0.0;
+		VONETrace::Trace_Request Request;
+		bool Pending = Reader.next(Request);
+
+		while (Pending || !Calendar.empty())
+		{
+			bool Departure = !Calendar.empty() && (!Pending || Calendar.top()._time <= Request._arrival_time);
+			double Time = Departure ? Calendar.top()._time : Request._arrival_time;
+			if (Time < Now)
+			{
+				cerr << "The arrival times of the trace should not decrease!\n";
+				exit(1);
+			}
+			Result._event_num++;
+
+			//The number of the embedded virtual networks is averaged from the first counted arrival to the last arrival:
+			if (Arrival > Warmup_Num && Pending)
+				Active_Area += _heuristic.get_active_num() * (Time - Now);
+			Now = Time;
+
+			if (Departure)
+			{
+				_heuristic.release(Calendar.top()._handle);
+				Calendar.pop();
+				continue;
+			}
+
+			Arrival++;
+			if (Arrival == Warmup_Num + 1)
+				Measure_Start = Now;
+			Measure_End = Now;
+
+			int Handle = admit(Request._topology, Result);
+			if (Arrival > Warmup_Num)
+			{
+				Result._arrival_num++;
+				Holding_Area += max(Request._holding_time, 0.0);
+				if (Handle == -1)
+					Result._block_num++;
+			}
+			if (Handle != -1 && Request._holding_time > 0)
+			{
+				Event Departure_Event = { Now + Request._holding_time, Handle };
+				Calendar.push(Departure_Event);
+			}
+			Pending = Reader.next(Request);
+		}
+
+		if (Result._arrival_num == 0)
+		{
+			cerr << "There should be at least one request after the warm-up in the trace!\n";
+			exit(1);
+		}
+		if (Measure_End > Measure_Start)
+		{
+			Result._average_active = Active_Area / (Measure_End - Measure_Start);
+			Result._erlang_load = Holding_Area / (Measure_End - Measure_Start);
+		}
+		_result.push_back(Result);
+	}
+
+	double Dynamic_Simulator::get_blocking_probability() const
+	{
+		if (_result.empty())
+		{
+			cerr << "The dynamic simulator has not been run!\n";
+			exit(1);
+		}
+		return static_cast<double>(_result.back()._block_num) / _result.back()._arrival_num;
+	}
+
+	const vector<Load_Result>& Dynamic_Simulator::get_result() const
+	{
+		return _result;
+	}
+
+	ostream& operator <<(ostream& outs, const Dynamic_Simulator& Simulator)
+	{
+		outs << "----------Blocking Probability----------\n\n";
+		outs << "Erlang Load\tArrivals\tBlocked\tBlocking Probability\tAverage Active\tEvents\tMoved\n";
+		for (vector<Load_Result>::const_iterator iter = Simulator._result.begin(); iter != Simulator._result.end(); iter++)
+		{
+			outs << iter->_erlang_load << "\t" << iter->_arrival_num << "\t" << iter->_block_num << "\t"
+				<< static_cast<double>(iter->_block_num) / iter->_arrival_num << "\t" << iter->_average_active << "\t" << iter->_event_num << "\t" << iter->_moved_num << "\n";
+		}
+		outs << "\n----------------------------------------\n\n";
+
+		return outs;
+	}
+
+	Dynamic_Simulator::~Dynamic_Simulator()
+	{
+
+	}
+
+	int Dynamic_Simulator::admit(const VONETopo::Topo& Virtual_Network, Load_Result& Result)
+	{
+		int Handle = _heuristic.embed(Virtual_Network)._handle;
+		if (Handle == -1 && _defragmentation_budget > 0)
+		{
+			int Moved = _heuristic.defragment(_defragmentation_budget);
+			Result._moved_num += Moved;
+			if (Moved > 0)
+				Handle = _heuristic.embed(Virtual_Network)._handle;
+		}
+		return Handle;
+	}
+
+	void Dynamic_Simulator::generate(VONETopo::Topo& Virtual_Network)
+	{
+		Virtual_Network = VONETopo::Topo();
+
+		int VN_Vertex = 2 + uniform_int_distribution<int>(0, 2)(_generator);	//4 Node
+		for (int j = 1; j <= VN_Vertex; j++)
+		{
+			int VN_Vertex_CPU = 1 + uniform_int_distribution<int>(0, 4)(_generator);
+			Virtual_Network.AddVertex(j, VN_Vertex_CPU);
+		}
+
+		int VN_Demand = 3 + uniform_int_distribution<int>(0, 2)(_generator);
+		int VN_Edge = VN_Vertex - 1 + uniform_int_distribution<int>(0, VN_Vertex * (VN_Vertex - 1) / 2 - (VN_Vertex - 1))(_generator);
+		int Used_Edge_Num = 1, Edge_Step = 1;
+		bool end_flag = false;
+		while (true)
+		{
+			int Vertex_Row = 1;
+			int Vertex_Column = Vertex_Row + Edge_Step;
+			while (Vertex_Column <= VN_Vertex)
+			{
+				Virtual_Network.AddEdge(Vertex_Row, Vertex_Column, VN_Demand);
+				Vertex_Column++;
+				Vertex_Row++;
+				Used_Edge_Num++;
+				if (Used_Edge_Num > VN_Edge)
+				{
+					end_flag = true;
+					break;
+				}
+			}
+			if (end_flag)
+				break;
+			Edge_Step++;
+		}
+	}
+}
+
+namespace
+{
+	void Check_Run(const double Erlang_Load, const double Mean_Holding_Time, const long long Request_Num, const long long Warmup_Num)
+	{
+		if (Erlang_Load <= 0 || Mean_Holding_Time <= 0 || Request_Num < 1 || Warmup_Num < 0)
+		{
+			cerr << "Erlang load and mean holding time should be positive, and there should be at least one request!\n";
+			exit(1);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+//This file declares class dynamic simulator.
+//------------------------------------------------
+//File Name: Simulator.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include "Heuristic.h"
+#include "Trace.h"
+
+#include <random>
+
+namespace VONESimulator
+{
+	//The statistics of the dynamic traffic under one Erlang load
+	struct Load_Result
+	{
+		double _erlang_load;
+		long long _arrival_num;		//The arrivals counted after the warm-up
+		long long _block_num;		//The blocked ones among _arrival_num
+		long long _event_num;		//All arrivals and departures handled, including the warm-up
+		long long _moved_num;		//The virtual networks moved by the defragmentation, including the warm-up
+		double _average_active;		//The time average of the number of the embedded virtual networks
+	};
+
+	//Create the discrete event simulator of the dynamic traffic, where the virtual networks arrive as a Poisson process,
+	//    hold the resources for an exponential time and then depart. The arrivals and departures are kept in an event calendar
+	//    ordered by time, each arrival is embedded by the heuristic and each departure releases its resources
+	class Dynamic_Simulator
+	{
+	public:
+		Dynamic_Simulator(const VONETopo::Topo& Substrate_Network, const VONELayout::Core_Layout& Layout,
+			int HeterogeneousCoreIndex, string CrosstalkYesorNo, const unsigned int Seed = 1);
+		//Precondition: Topology of substrate network has been assigned, and Layout has been built
+		//Postcondition: The simulator works on Substrate_Network with the cores arranged as Layout, and the random virtual networks are generated from Seed
+
+		void set_defragmentation(const double Time_Budget);
+		//Precondition: Time_Budget >= 0 is in milliseconds
+		//Postcondition: When an arrival is blocked, the spectrum is defragmented within Time_Budget and the arrival is tried once more, 
+		//    0 turns the defragmentation off, which is the default
+
+		void set_path_candidate_num(const int K);
+		//Precondition: K >= 0
+		//Postcondition: The heuristic embeds the virtual links on the K shortest paths as VONEHeuristic::set_path_candidate_num, 
+		//    0 embeds them on the shortest paths weighted by the Path Distances, which is the default
+
+		void run(const double Erlang_Load, const double Mean_Holding_Time, const long long Request_Num, const long long Warmup_Num = 0);
+		//Precondition: Erlang_Load > 0, Mean_Holding_Time > 0, Request_Num >= 1 and Warmup_Num >= 0
+		//Postcondition: Warmup_Num and then Request_Num virtual networks have arrived with the rate Erlang_Load / Mean_Holding_Time on an idle substrate network,
+		//    and the statistics of the latter have been appended to _result
+
+		void run_trace(VONETrace::Trace_Reader& Reader, const long long Warmup_Num = 0);
+		//Precondition: The arrival times of the requests of Reader do not decrease
+		//Postcondition: The requests of Reader have arrived one by one on an idle substrate network and departed after their holding times, 
+		//    and the statistics of those after the first Warmup_Num have been appended to _result, with the Erlang load offered by them. 
+		//    The requests are read only when they arrive, so the memory is bounded by the embedded virtual networks however long the trace is
+
+		double get_blocking_probability() const;
+		//Precondition: run has been excuted
+		//Postcondition: Return the blocking probability of the last run
+
+		const vector<Load_Result>& get_result() const;
+		//Postcondition: Return the statistics of all runs in order
+
+		friend ostream& operator <<(ostream& outs, const Dynamic_Simulator& Simulator);
+		//Precondition: outs has been connected to an out stream
+		//Postcondition: Print the blocking probability against the Erlang load of all runs to outs
+
+		~Dynamic_Simulator();
+
+	private:
+		int admit(const VONETopo::Topo& Virtual_Network, Load_Result& Result);
+		//Postcondition: Virtual_Network has been embedded, after the defragmentation when it is blocked and the defragmentation is on. 
+		//    Return its handle, or -1 when it is blocked, and the moved virtual networks have been counted into Result
+
+		void generate(VONETopo::Topo& Virtual_Network);
+		//Postcondition: Virtual_Network has been replaced by a random virtual network, generated in the same way as the main function
+
+		VONETopo::Topo _substrate;
+		VONELayout::Core_Layout _layout;
+		int _hetergeneous_core;
+		string _crosstalk;
+		double _defragmentation_budget;
+		int _path_candidate_num;
+		VONEHeuristic::VONEHeuristic _heuristic;
+		mt19937 _generator;
+		vector<Load_Result> _result;
+	};
+}
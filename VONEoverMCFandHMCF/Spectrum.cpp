@@ -0,0 +1,690 @@
+//This file defines class spectrum bitmap, transaction and arena, and the free run index of the bitmap.
+//------------------------------------------------
+//File Name: Spectrum.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Spectrum.h"
+
+#include <algorithm>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	int Trailing_Zero(const VONESpectrum::Spectrum_Word Word);
+	//Precondition: Word is not 0
+	//Postcondition: Return the index of the lowest set bit of Word
+
+	int Highest_Bit(const VONESpectrum::Spectrum_Word Word);
+	//Precondition: Word is not 0
+	//Postcondition: Return the index of the highest set bit of Word
+
+	VONESpectrum::Spectrum_Word Range_Mask(const int Low, const int High);
+	//Precondition: 0 <= Low <= High < Word_Bits
+	//Postcondition: Return the word whose bits from Low to High are set
+
+	VONESpectrum::Free_Run Leaf_Run(const VONESpectrum::Spectrum_Word Free);
+	//Precondition: The bits of Free are set for the free frequency slots of one word
+	//Postcondition: Return the free run index node of the word
+
+	VONESpectrum::Free_Run Merge_Run(const VONESpectrum::Free_Run& Left, const VONESpectrum::Free_Run& Right, const int Child_Slot_Num);
+	//Precondition: Left and Right are the adjacent nodes covering Child_Slot_Num frequency slots each
+	//Postcondition: Return the node covering both of them
+}
+
+namespace VONESpectrum
+{
+	int Free_Run_Num(const int Slot_Num)
+	{
+		int word_num = (Slot_Num + Word_Bits - 1) / Word_Bits;
+		if (word_num == 0)
+			return 0;
+
+		int leaf_num = 1;
+		while (leaf_num < word_num)
+			leaf_num *= 2;
+		return 2 * leaf_num;
+	}
+
+	Spectrum_Bitmap::Spectrum_Bitmap() : _word(NULL), _slot_num(0), _word_num(0), _index(NULL), _leaf_num(0)
+	{
+
+	}
+
+	Spectrum_Bitmap::Spectrum_Bitmap(Spectrum_Word* Word, const int Slot_Num, Free_Run* Index) 
+		: _word(Word), _slot_num(Slot_Num), _word_num((Slot_Num + Word_Bits - 1) / Word_Bits), _index(Index), _leaf_num(0)
+	{
+		if (_index != NULL)
+			_leaf_num = Free_Run_Num(Slot_Num) / 2;
+		if (_leaf_num == 0)
+			_index = NULL;
+	}
+
+	void Spectrum_Bitmap::build_index()
+	{
+		if (_index == NULL)
+			return;
+
+		//The leaves beyond _word_num stay fully occupied so that no free run reaches them:
+		Free_Run occupied = { 0, 0, 0 };
+		fill(_index, _index + 2 * _leaf_num, occupied);
+		update_index(0, _word_num - 1);
+	}
+
+	bool Spectrum_Bitmap::is_free(const int Start, const int Width) const
+	{
+		int low = Start - 1, high = Start + Width - 2;
+		for (int w = low / Word_Bits; w <= high / Word_Bits; w++)
+		{
+			int first = max(low, w * Word_Bits) - w * Word_Bits;
+			int last = min(high, w * Word_Bits + Word_Bits - 1) - w * Word_Bits;
+			if (_word[w] & Range_Mask(first, last))
+				return false;
+		}
+		return true;
+	}
+
+	void Spectrum_Bitmap::occupy(const int Start, const int Width)
+	{
+		int low = Start - 1, high = Start + Width - 2;
+		for (int w = low / Word_Bits; w <= high / Word_Bits; w++)
+		{
+			int first = max(low, w * Word_Bits) - w * Word_Bits;
+			int last = min(high, w * Word_Bits + Word_Bits - 1) - w * Word_Bits;
+			_word[w] |= Range_Mask(first, last);
+		}
+		if (_index != NULL)
+			update_index(low / Word_Bits, high / Word_Bits);
+	}
+
+	void Spectrum_Bitmap::release(const int Start, const int Width)
+	{
+		int low = Start - 1, high = Start + Width - 2;
+		for (int w = low / Word_Bits; w <= high / Word_Bits; w++)
+		{
+			int first = max(low, w * Word_Bits) - w * Word_Bits;
+			int last = min(high, w * Word_Bits + Word_Bits - 1) - w * Word_Bits;
+			_word[w] &= ~Range_Mask(first, last);
+		}
+		if (_index != NULL)
+			update_index(low / Word_Bits, high / Word_Bits);
+	}
+
+	void Spectrum_Bitmap::run_start_mask(const int Width, vector<Spectrum_Word>& Mask) const
+	{
+		//The free bits, with the bits beyond _slot_num treated as occupied:
+		Mask.resize(_word_num);
+		for (int w = 0; w < _word_num; w++)
+			Mask[w] = free_word(w);
+
+		//A run of Width free slots begins where Mask & (Mask >> 1) & ... & (Mask >> (Width - 1)) is set,
+		//    the covered length is doubled by each shift-and-and:
+		for (int covered = 1; covered < Width; )
+		{
+			int shift = min(covered, Width - covered);
+			Shift_And(Mask, shift);
+			covered += shift;
+		}
+	}
+
+	int Spectrum_Bitmap::first_fit(const int Width, const int From) const
+	{
+		if (_index == NULL || From != 1)
+		{
+			vector<Spectrum_Word> mask;
+			run_start_mask(Width, mask);
+			return Lowest_Slot(mask, From);
+		}
+
+		if (_index[1]._longest < Width)
+			return 0;
+
+		//Descend to the leftmost node holding the run, a run across the two children is found at their parent:
+		int node = 1, low_word = 0;
+		for (int leaf_width = _leaf_num; node < _leaf_num; leaf_width /= 2)
+		{
+			const Free_Run& left = _index[2 * node];
+			const Free_Run& right = _index[2 * node + 1];
+			if (left._longest >= Width)
+				node = 2 * node;
+			else if (left._suffix + right._prefix >= Width)
+				return (low_word + leaf_width / 2) * Word_Bits - left._suffix + 1;
+			else
+			{
+				node = 2 * node + 1;
+				low_word += leaf_width / 2;
+			}
+		}
+
+		//The run lies inside one word:
+		Spectrum_Word mask = free_word(low_word);
+		for (int covered = 1; covered < Width; )
+		{
+			int shift = min(covered, Width - covered);
+			mask &= mask >> shift;
+			covered += shift;
+		}
+		return low_word * Word_Bits + Trailing_Zero(mask) + 1;
+	}
+
+	int Spectrum_Bitmap::highest_used_slot() const
+	{
+		if (_index != NULL)
+		{
+			int w = highest_used_word(1, 0, _leaf_num);
+			return w < 0 ? 0 : w * Word_Bits + Highest_Bit(_word[w]) + 1;
+		}
+
+		for (int w = _word_num - 1; w >= 0; w--)
+		{
+			if (_word[w] != 0)
+				return w * Word_Bits + Highest_Bit(_word[w]) + 1;
+		}
+		return 0;
+	}
+
+	int Spectrum_Bitmap::largest_free_run() const
+	{
+		if (_index != NULL)
+			return _index[1]._longest;
+
+		int longest = 0, run = 0;
+		for (int w = 0; w < _word_num; w++)
+		{
+			Free_Run leaf = Leaf_Run(free_word(w));
+			longest = max(longest, max(leaf._longest, run + leaf._prefix));
+			run = leaf._prefix == Word_Bits ? run + Word_Bits : leaf._suffix;
+		}
+		return longest;
+	}
+
+	int Spectrum_Bitmap::get_slot_num() const
+	{
+		return _slot_num;
+	}
+
+	Spectrum_Bitmap Spectrum_Bitmap::unindexed() const
+	{
+		return Spectrum_Bitmap(_word, _slot_num);
+	}
+
+	Spectrum_Bitmap::~Spectrum_Bitmap()
+	{
+
+	}
+
+	void Spectrum_Bitmap::update_index(const int Low_Word, const int High_Word)
+	{
+		for (int w = Low_Word; w <= High_Word; w++)
+			_index[_leaf_num + w] = Leaf_Run(free_word(w));
+
+		//Only the ancestors of the updated leaves change, level by level:
+		int low = _leaf_num + Low_Word, high = _leaf_num + High_Word;
+		for (int child_slot_num = Word_Bits; low > 1; child_slot_num *= 2)
+		{
+			low /= 2;
+			high /= 2;
+			for (int node = low; node <= high; node++)
+				_index[node] = Merge_Run(_index[2 * node], _index[2 * node + 1], child_slot_num);
+		}
+	}
+
+	int Spectrum_Bitmap::highest_used_word(const int Node, const int Low_Word, const int Leaf_Width) const
+	{
+		if (Low_Word >= _word_num || _index[Node]._prefix == Leaf_Width * Word_Bits)
+			return -1;
+		if (Leaf_Width == 1)
+			return _word[Low_Word] != 0 ? Low_Word : -1;
+
+		int word = highest_used_word(2 * Node + 1, Low_Word + Leaf_Width / 2, Leaf_Width / 2);
+		if (word >= 0)
+			return word;
+		return highest_used_word(2 * Node, Low_Word, Leaf_Width / 2);
+	}
+
+	Spectrum_Word Spectrum_Bitmap::free_word(const int Word) const
+	{
+		Spectrum_Word free = ~_word[Word];
+		if (Word == _word_num - 1 && _slot_num % Word_Bits != 0)
+			free &= Range_Mask(0, _slot_num % Word_Bits - 1);
+		return free;
+	}
+
+	Spectrum_Transaction::Spectrum_Transaction()
+	{
+
+	}
+
+	void Spectrum_Transaction::reserve(Spectrum_Bitmap Occupancy, const int Start, const int Width)
+	{
+		Reservation reservation = { Occupancy, Start, Width };
+		Occupancy.occupy(Start, Width);
+		_undo_log.push_back(reservation);
+	}
+
+	void Spectrum_Transaction::save_end_slot(Spectrum_Arena& Arena, const int Link, const int Core)
+	{
+		Saved_Cell cell = { &Arena, Link, Core, Arena.end_slot(Link, Core) };
+		_cell_log.push_back(cell);
+	}
+
+	void Spectrum_Transaction::save_path_distance(Spectrum_Arena& Arena, const int Link)
+	{
+		Saved_Cell cell = { &Arena, Link, 0, Arena.path_distance(Link) };
+		_cell_log.push_back(cell);
+	}
+
+	void Spectrum_Transaction::rollback()
+	{
+		for (vector<Reservation>::reverse_iterator iter = _undo_log.rbegin(); iter != _undo_log.rend(); iter++)
+			iter->_occupancy.release(iter->_start, iter->_width);
+		_undo_log.clear();
+
+		//The first value recorded for a cell is the last one written back:
+		for (vector<Saved_Cell>::reverse_iterator iter = _cell_log.rbegin(); iter != _cell_log.rend(); iter++)
+		{
+			if (iter->_core >= 1)
+				iter->_arena->end_slot(iter->_link, iter->_core) = iter->_value;
+			else
+				iter->_arena->set_path_distance(iter->_link, iter->_value);
+		}
+		_cell_log.clear();
+	}
+
+	void Spectrum_Transaction::commit()
+	{
+		_undo_log.clear();
+		_cell_log.clear();
+	}
+
+	bool Spectrum_Transaction::empty() const
+	{
+		return _undo_log.empty() && _cell_log.empty();
+	}
+
+	Spectrum_Transaction::~Spectrum_Transaction()
+	{
+
+	}
+
+	Spectrum_Arena::Spectrum_Arena()
+	{
+		//Even with no link the block holds the totals of the Path Distances, so it is allocated as for any size:
+		layout(0, 0, 0);
+		_storage.resize((_byte_size + sizeof(Spectrum_Word) - 1) / sizeof(Spectrum_Word));
+		_base = _storage.data();
+		clear();
+	}
+
+	Spectrum_Arena::Spectrum_Arena(const int Link_Num, const int Core_Num, const int Slot_Num, void* External_Storage)
+	{
+		layout(Link_Num, Core_Num, Slot_Num);
+		if (External_Storage == NULL)
+		{
+			_storage.resize((_byte_size + sizeof(Spectrum_Word) - 1) / sizeof(Spectrum_Word));
+			_base = _storage.data();
+			clear();
+		}
+		else
+			_base = static_cast<Spectrum_Word*>(External_Storage);
+	}
+
+	Spectrum_Arena::Spectrum_Arena(const Spectrum_Arena& Snapshot)
+	{
+		layout(Snapshot._link_num, Snapshot._core_num, Snapshot._slot_num);
+		_storage.resize((_byte_size + sizeof(Spectrum_Word) - 1) / sizeof(Spectrum_Word));
+		_base = _storage.data();
+		if (_byte_size != 0)
+			memcpy(_base, Snapshot._base, _byte_size);
+	}
+
+	Spectrum_Arena& Spectrum_Arena::operator =(const Spectrum_Arena& Snapshot)
+	{
+		if (this == &Snapshot)
+			return *this;
+
+		if (_link_num != Snapshot._link_num || _core_num != Snapshot._core_num || _slot_num != Snapshot._slot_num)
+		{
+			layout(Snapshot._link_num, Snapshot._core_num, Snapshot._slot_num);
+			_storage.assign((_byte_size + sizeof(Spectrum_Word) - 1) / sizeof(Spectrum_Word), 0);
+			_base = _storage.data();
+		}
+		if (_byte_size != 0)
+			memcpy(_base, Snapshot._base, _byte_size);
+		return *this;
+	}
+
+	void Spectrum_Arena::clear()
+	{
+		memset(_base, 0, _byte_size);
+		for (int l = 0; l < _link_num; l++)
+		{
+			for (int c = 1; c <= _core_num; c++)
+				end_slot(l, c) = 1;
+			reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _path_distance_offset)[l] = 1;
+			for (int ci = 0; ci < 2 * _core_num; ci++)
+				occupancy(l, ci).build_index();
+		}
+		distance_count_cell(1) = _link_num;
+		distance_sum_cell() = _link_num;
+		distance_max_cell() = (_link_num == 0) ? 0 : 1;
+	}
+
+	Spectrum_Bitmap Spectrum_Arena::occupancy(const int Link, const int Core_Index)
+	{
+		size_t cell = static_cast<size_t>(Link) * 2 * _core_num + Core_Index;
+		return Spectrum_Bitmap(_base + cell * _word_num, _slot_num, 
+			reinterpret_cast<Free_Run*>(reinterpret_cast<char*>(_base) + _free_run_offset) + cell * _free_run_num);
+	}
+
+	const Spectrum_Bitmap Spectrum_Arena::occupancy(const int Link, const int Core_Index) const
+	{
+		size_t cell = static_cast<size_t>(Link) * 2 * _core_num + Core_Index;
+		return Spectrum_Bitmap(_base + cell * _word_num, _slot_num, 
+			reinterpret_cast<Free_Run*>(reinterpret_cast<char*>(_base) + _free_run_offset) + cell * _free_run_num);
+	}
+
+	signed char* Spectrum_Arena::service_type(const int Link, const int Core_Index)
+	{
+		return reinterpret_cast<signed char*>(_base) + _service_type_offset 
+			+ (static_cast<size_t>(Link) * 2 * _core_num + Core_Index) * _slot_num;
+	}
+
+	const signed char* Spectrum_Arena::service_type(const int Link, const int Core_Index) const
+	{
+		return reinterpret_cast<const signed char*>(_base) + _service_type_offset 
+			+ (static_cast<size_t>(Link) * 2 * _core_num + Core_Index) * _slot_num;
+	}
+
+	int& Spectrum_Arena::end_slot(const int Link, const int Core)
+	{
+		return reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _end_slot_offset)[Link * _core_num + Core - 1];
+	}
+
+	int Spectrum_Arena::end_slot(const int Link, const int Core) const
+	{
+		return reinterpret_cast<const int*>(reinterpret_cast<const char*>(_base) + _end_slot_offset)[Link * _core_num + Core - 1];
+	}
+
+	int Spectrum_Arena::path_distance(const int Link) const
+	{
+		return reinterpret_cast<const int*>(reinterpret_cast<const char*>(_base) + _path_distance_offset)[Link];
+	}
+
+	void Spectrum_Arena::set_path_distance(const int Link, const int Distance)
+	{
+		int& distance = reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _path_distance_offset)[Link];
+		if (distance == Distance)
+			return;
+		distance_count_cell(distance)--;
+		distance_count_cell(Distance)++;
+		distance_sum_cell() += Distance - distance;
+
+		//The maximum only falls when the last link at it has left, and then down to the next Path Distance held by a link:
+		int& max_distance = distance_max_cell();
+		if (Distance > max_distance)
+			max_distance = Distance;
+		else if (distance == max_distance)
+		{
+			while (max_distance > 0 && distance_count_cell(max_distance) == 0)
+				max_distance--;
+		}
+		distance = Distance;
+	}
+
+	int Spectrum_Arena::max_path_distance() const
+	{
+		return *reinterpret_cast<const int*>(reinterpret_cast<const char*>(_base) + _distance_total_offset + sizeof(long long));
+	}
+
+	long long Spectrum_Arena::sum_path_distance() const
+	{
+		return *reinterpret_cast<const long long*>(reinterpret_cast<const char*>(_base) + _distance_total_offset);
+	}
+
+	void Spectrum_Arena::assign(const int Link, const int Core_Index, const int Start, const int Width, const int Service_Type, 
+		const VONELayout::Core_Mask Crosstalk_Mask)
+	{
+		signed char* tag = service_type(Link, Core_Index);
+		for (int k = Start; k <= Start + Width - 1; k++)
+			tag[k - 1] = static_cast<signed char>(Service_Type);
+		used_slot_cell(Link, Core_Index) += Width;
+		crosstalk_cell(Link) += crosstalk_match(Link, Core_Index, Start, Width, Crosstalk_Mask);
+	}
+
+	void Spectrum_Arena::unassign(const int Link, const int Core_Index, const int Start, const int Width, const VONELayout::Core_Mask Crosstalk_Mask)
+	{
+		crosstalk_cell(Link) -= crosstalk_match(Link, Core_Index, Start, Width, Crosstalk_Mask);
+		used_slot_cell(Link, Core_Index) -= Width;
+		signed char* tag = service_type(Link, Core_Index);
+		for (int k = Start; k <= Start + Width - 1; k++)
+			tag[k - 1] = 0;
+	}
+
+	int Spectrum_Arena::highest_used_slot(const int Link, const int Core_Index) const
+	{
+		return occupancy(Link, Core_Index).highest_used_slot();
+	}
+
+	int Spectrum_Arena::used_slot_num(const int Link, const int Core_Index) const
+	{
+		return reinterpret_cast<const int*>(reinterpret_cast<const char*>(_base) + _used_slot_offset)[Link * 2 * _core_num + Core_Index];
+	}
+
+	int Spectrum_Arena::fragmentation(const int Link, const int Core_Index) const
+	{
+		return highest_used_slot(Link, Core_Index) - used_slot_num(Link, Core_Index);
+	}
+
+	int Spectrum_Arena::crosstalk(const int Link) const
+	{
+		return reinterpret_cast<const int*>(reinterpret_cast<const char*>(_base) + _crosstalk_offset)[Link];
+	}
+
+	int Spectrum_Arena::get_link_num() const
+	{
+		return _link_num;
+	}
+
+	int Spectrum_Arena::get_core_num() const
+	{
+		return _core_num;
+	}
+
+	int Spectrum_Arena::get_slot_num() const
+	{
+		return _slot_num;
+	}
+
+	const void* Spectrum_Arena::data() const
+	{
+		return _base;
+	}
+
+	size_t Spectrum_Arena::byte_size() const
+	{
+		return _byte_size;
+	}
+
+	size_t Spectrum_Arena::byte_size(const int Link_Num, const int Core_Num, const int Slot_Num)
+	{
+		Spectrum_Arena arena;
+		arena.layout(Link_Num, Core_Num, Slot_Num);
+		return arena._byte_size;
+	}
+
+	void Spectrum_Arena::layout(const int Link_Num, const int Core_Num, const int Slot_Num)
+	{
+		_link_num = Link_Num;
+		_core_num = Core_Num;
+		_slot_num = Slot_Num;
+		_word_num = (Slot_Num + Word_Bits - 1) / Word_Bits;
+		_free_run_num = Free_Run_Num(Slot_Num);
+
+		size_t cell_num = static_cast<size_t>(Link_Num) * 2 * Core_Num;
+		_free_run_offset = cell_num * _word_num * sizeof(Spectrum_Word);
+		_end_slot_offset = _free_run_offset + cell_num * _free_run_num * sizeof(Free_Run);
+		_path_distance_offset = _end_slot_offset + static_cast<size_t>(Link_Num) * Core_Num * sizeof(int);
+		_distance_count_offset = _path_distance_offset + static_cast<size_t>(Link_Num) * sizeof(int);
+		_used_slot_offset = _distance_count_offset + (static_cast<size_t>(max(Slot_Num, 1)) + 1) * sizeof(int);
+		_crosstalk_offset = _used_slot_offset + cell_num * sizeof(int);
+		_service_type_offset = _crosstalk_offset + static_cast<size_t>(Link_Num) * sizeof(int);
+		_distance_total_offset = (_service_type_offset + cell_num * Slot_Num + sizeof(long long) - 1) / sizeof(long long) * sizeof(long long);
+		_byte_size = _distance_total_offset + 2 * sizeof(long long);
+	}
+
+	int Spectrum_Arena::crosstalk_match(const int Link, const int Core_Index, const int Start, const int Width, const VONELayout::Core_Mask Crosstalk_Mask) const
+	{
+		int direction = Core_Index % 2;
+		const signed char* tag = service_type(Link, Core_Index);
+
+		int match = 0;
+		for (VONELayout::Core_Mask mask = Crosstalk_Mask; mask != 0; mask &= mask - 1)
+		{
+			const signed char* neighbour_tag = service_type(Link, 2 * (VONELayout::Lowest_Core(mask) - 1) + direction);
+			for (int k = Start; k <= Start + Width - 1; k++)
+			{
+				if (tag[k - 1] != 0 && tag[k - 1] == neighbour_tag[k - 1])
+					match++;
+			}
+		}
+		return match;
+	}
+
+	int& Spectrum_Arena::used_slot_cell(const int Link, const int Core_Index)
+	{
+		return reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _used_slot_offset)[Link * 2 * _core_num + Core_Index];
+	}
+
+	int& Spectrum_Arena::crosstalk_cell(const int Link)
+	{
+		return reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _crosstalk_offset)[Link];
+	}
+
+	int& Spectrum_Arena::distance_count_cell(const int Distance)
+	{
+		return reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _distance_count_offset)[Distance];
+	}
+
+	long long& Spectrum_Arena::distance_sum_cell()
+	{
+		return *reinterpret_cast<long long*>(reinterpret_cast<char*>(_base) + _distance_total_offset);
+	}
+
+	int& Spectrum_Arena::distance_max_cell()
+	{
+		return *reinterpret_cast<int*>(reinterpret_cast<char*>(_base) + _distance_total_offset + sizeof(long long));
+	}
+
+	Spectrum_Arena::~Spectrum_Arena()
+	{
+
+	}
+
+	void Shift_And(vector<Spectrum_Word>& Mask, const int Shift)
+	{
+		int word_shift = Shift / Word_Bits, bit_shift = Shift % Word_Bits;
+		int word_num = static_cast<int>(Mask.size());
+
+		//Ascending order reads only the words which have not been updated yet:
+		for (int w = 0; w < word_num; w++)
+		{
+			Spectrum_Word shifted = 0;
+			if (w + word_shift < word_num)
+				shifted = Mask[w + word_shift] >> bit_shift;
+			if (bit_shift != 0 && w + word_shift + 1 < word_num)
+				shifted |= Mask[w + word_shift + 1] << (Word_Bits - bit_shift);
+			Mask[w] &= shifted;
+		}
+	}
+
+	void Mask_And(vector<Spectrum_Word>& Mask, const vector<Spectrum_Word>& Other)
+	{
+		for (unsigned int w = 0; w < Mask.size(); w++)
+			Mask[w] &= Other[w];
+	}
+
+	void Mask_Or(vector<Spectrum_Word>& Mask, const vector<Spectrum_Word>& Other)
+	{
+		for (unsigned int w = 0; w < Mask.size(); w++)
+			Mask[w] |= Other[w];
+	}
+
+	int Lowest_Slot(const vector<Spectrum_Word>& Mask, const int From)
+	{
+		int word_num = static_cast<int>(Mask.size());
+		int w = (From - 1) / Word_Bits;
+		if (w >= word_num)
+			return 0;
+
+		Spectrum_Word word = Mask[w] & ~((1ULL << ((From - 1) % Word_Bits)) - 1);
+		while (word == 0)
+		{
+			if (++w >= word_num)
+				return 0;
+			word = Mask[w];
+		}
+		return w * Word_Bits + Trailing_Zero(word) + 1;
+	}
+}
+
+namespace
+{
+	int Trailing_Zero(const VONESpectrum::Spectrum_Word Word)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, Word);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(Word);
+#endif
+	}
+
+	int Highest_Bit(const VONESpectrum::Spectrum_Word Word)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse64(&index, Word);
+		return static_cast<int>(index);
+#else
+		return VONESpectrum::Word_Bits - 1 - __builtin_clzll(Word);
+#endif
+	}
+
+	VONESpectrum::Spectrum_Word Range_Mask(const int Low, const int High)
+	{
+		VONESpectrum::Spectrum_Word upto_high = High == VONESpectrum::Word_Bits - 1 ? ~0ULL : (1ULL << (High + 1)) - 1;
+		return upto_high & ~((1ULL << Low) - 1);
+	}
+
+	VONESpectrum::Free_Run Leaf_Run(const VONESpectrum::Spectrum_Word Free)
+	{
+		VONESpectrum::Free_Run leaf = { VONESpectrum::Word_Bits, VONESpectrum::Word_Bits, VONESpectrum::Word_Bits };
+		if (Free == ~0ULL)
+			return leaf;
+
+		leaf._prefix = Trailing_Zero(~Free);
+		leaf._suffix = VONESpectrum::Word_Bits - 1 - Highest_Bit(~Free);
+
+		//Each shift-and-and shortens every free run by one slot:
+		leaf._longest = 0;
+		for (VONESpectrum::Spectrum_Word run = Free; run != 0; run &= run >> 1)
+			leaf._longest++;
+		return leaf;
+	}
+
+	VONESpectrum::Free_Run Merge_Run(const VONESpectrum::Free_Run& Left, const VONESpectrum::Free_Run& Right, const int Child_Slot_Num)
+	{
+		VONESpectrum::Free_Run node;
+		node._prefix = Left._prefix == Child_Slot_Num ? Child_Slot_Num + Right._prefix : Left._prefix;
+		node._suffix = Right._suffix == Child_Slot_Num ? Child_Slot_Num + Left._suffix : Right._suffix;
+		node._longest = max(max(Left._longest, Right._longest), Left._suffix + Right._prefix);
+		return node;
+	}
+}
@@ -0,0 +1,317 @@
+//This file declares class spectrum bitmap, transaction and arena, and the free run index of the bitmap.
+//------------------------------------------------
+//File Name: Spectrum.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstddef>
+#include "Layout.h"
+
+using namespace std;
+
+namespace VONESpectrum
+{
+	typedef unsigned long long Spectrum_Word;
+	const int Word_Bits = 64;
+
+	//One node of the free run index, which is a segment tree over the words of a bitmap, 
+	//    covering the free slots at the beginning and the end of the node and the longest free run inside it
+	struct Free_Run
+	{
+		int _prefix;
+		int _suffix;
+		int _longest;
+	};
+
+	int Free_Run_Num(const int Slot_Num);
+	//Postcondition: Return the number of the nodes of the free run index of Slot_Num frequency slots
+
+	//The packed occupancy of the frequency slots in one core and one direction, which is a view of the words 
+	//    kept by Spectrum_Arena, the bit (Slot - 1) is set when the frequency slot Slot is occupied. 
+	//    When the free run index is attached, it is updated on each occupy and release, 
+	//    so that first_fit, highest_used_slot and largest_free_run descend it instead of scanning the words
+	class Spectrum_Bitmap
+	{
+	public:
+		Spectrum_Bitmap();
+
+		Spectrum_Bitmap(Spectrum_Word* Word, const int Slot_Num, Free_Run* Index = NULL);
+		//Precondition: Word points to (Slot_Num + Word_Bits - 1) / Word_Bits words which outlive the bitmap, 
+		//    Index is NULL or points to Free_Run_Num(Slot_Num) nodes built from Word
+		//Postcondition: The bitmap views the Slot_Num frequency slots packed in Word, and the free run index in Index
+
+		void build_index();
+		//Postcondition: The free run index has been rebuilt from the words if it is attached
+
+		bool is_free(const int Start, const int Width) const;
+		//Precondition: 1 <= Start and Start + Width - 1 <= _slot_num
+		//Postcondition: Return whether the frequency slots from Start to Start + Width - 1 are all free
+
+		void occupy(const int Start, const int Width);
+		//Precondition: 1 <= Start and Start + Width - 1 <= _slot_num
+		//Postcondition: The frequency slots from Start to Start + Width - 1 have been marked occupied
+
+		void release(const int Start, const int Width);
+		//Precondition: 1 <= Start and Start + Width - 1 <= _slot_num
+		//Postcondition: The frequency slots from Start to Start + Width - 1 have been marked free
+
+		void run_start_mask(const int Width, vector<Spectrum_Word>& Mask) const;
+		//Precondition: Width >= 1
+		//Postcondition: The bit (Start - 1) of Mask is set when Width contiguous free frequency slots begin at Start
+
+		int first_fit(const int Width, const int From = 1) const;
+		//Precondition: Width >= 1
+		//Postcondition: Return the first Start not smaller than From with Width contiguous free frequency slots, or 0 if there is none
+
+		int highest_used_slot() const;
+		//Postcondition: Return the biggest occupied frequency slot, or 0 if all frequency slots are free
+
+		int largest_free_run() const;
+		//Postcondition: Return the number of frequency slots in the longest run of free frequency slots
+
+		int get_slot_num() const;
+		//Postcondition: Return the number of frequency slots _slot_num
+
+		Spectrum_Bitmap unindexed() const;
+		//Postcondition: Return the view of the same words without the free run index, 
+		//    whose changes must be undone before the free run index is used again
+
+		~Spectrum_Bitmap();
+
+	private:
+		void update_index(const int Low_Word, const int High_Word);
+		//Precondition: The free run index is attached, and 0 <= Low_Word <= High_Word < _word_num
+		//Postcondition: The leaves of the words from Low_Word to High_Word and their ancestors have been updated
+
+		int highest_used_word(const int Node, const int Low_Word, const int Leaf_Width) const;
+		//Precondition: The free run index is attached, Node covers Leaf_Width words from Low_Word
+		//Postcondition: Return the biggest word under Node which has an occupied frequency slot, or -1 if there is none
+
+		Spectrum_Word free_word(const int Word) const;
+		//Precondition: 0 <= Word < _word_num
+		//Postcondition: Return the free bits of the word, with the bits beyond _slot_num treated as occupied
+
+		Spectrum_Word* _word;
+		int _slot_num;
+		int _word_num;
+		Free_Run* _index;		//Node 1 is the root, and the leaves begin at _leaf_num
+		int _leaf_num;
+	};
+
+	class Spectrum_Arena;
+
+	//The tentative reservation of frequency slots, only the touched slots are recorded in an undo log
+	//    so that rolling back or committing costs what has been reserved. The End Frequency Slots and the Path Distances 
+	//    changed by other means can be recorded as well, so that rollback writes their old values back
+	class Spectrum_Transaction
+	{
+	public:
+		Spectrum_Transaction();
+
+		void reserve(Spectrum_Bitmap Occupancy, const int Start, const int Width);
+		//Precondition: The frequency slots from Start to Start + Width - 1 in Occupancy are free
+		//Postcondition: The frequency slots have been occupied and recorded in _undo_log
+
+		void save_end_slot(Spectrum_Arena& Arena, const int Link, const int Core);
+		//Precondition: The same as the function end_slot of Arena, which outlives the transaction
+		//Postcondition: The End Frequency Slot of the core in the link has been recorded in _cell_log before it is changed
+
+		void save_path_distance(Spectrum_Arena& Arena, const int Link);
+		//Precondition: The same as the function path_distance of Arena, which outlives the transaction
+		//Postcondition: The Path Distance of the link has been recorded in _cell_log before it is changed
+
+		void rollback();
+		//Postcondition: The frequency slots recorded in _undo_log have been released and the values recorded in _cell_log 
+		//    have been written back, both in the reverse order, and both logs have been cleared
+
+		void commit();
+		//Postcondition: The frequency slots recorded in _undo_log keep occupied, the values recorded in _cell_log keep changed, 
+		//    and both logs have been cleared
+
+		bool empty() const;
+		//Postcondition: Return whether nothing has been reserved or recorded since the last rollback or commit
+
+		~Spectrum_Transaction();
+
+	private:
+		struct Reservation
+		{
+			Spectrum_Bitmap _occupancy;
+			int _start;
+			int _width;
+		};
+
+		//An End Frequency Slot when _core is at least 1, otherwise the Path Distance of _link
+		struct Saved_Cell
+		{
+			Spectrum_Arena* _arena;
+			int _link;
+			int _core;
+			int _value;
+		};
+
+		vector<Reservation> _undo_log;
+		vector<Saved_Cell> _cell_log;
+	};
+
+	//The spectrum state of all links of the substrate network in one contiguous block. The occupancy words are indexed as 
+	//    [link][core][direction][word] and followed by the free run index of each core and direction, the End Frequency Slot 
+	//    of each core, the Path Distance of each link, the number of links at each Path Distance, the used slot number of each core 
+	//    and direction, the Crosstalk of each link, the Service Type of each frequency slot indexed as [link][core][direction][slot], 
+	//    and the sum and the maximum of the Path Distances, so a snapshot is a single copy and the block can be placed in shared memory 
+	//    such as a mapped file. The metrics are kept up to date by assign, unassign and set_path_distance
+	class Spectrum_Arena
+	{
+	public:
+		Spectrum_Arena();
+		//Postcondition: The arena owns a cleared block with no link
+
+		Spectrum_Arena(const int Link_Num, const int Core_Num, const int Slot_Num, void* External_Storage = NULL);
+		//Precondition: External_Storage is NULL or points to byte_size(Link_Num, Core_Num, Slot_Num) bytes aligned to a word
+		//Postcondition: The arena owns a cleared block when External_Storage is NULL, 
+		//    otherwise it works on External_Storage and keeps its content, so that an existing state can be attached
+
+		Spectrum_Arena(const Spectrum_Arena& Snapshot);
+		//Postcondition: The arena owns a copy of the block of Snapshot
+
+		Spectrum_Arena& operator =(const Spectrum_Arena& Snapshot);
+		//Postcondition: The block of Snapshot has been copied in place when the sizes agree, even in External_Storage,
+		//    otherwise the arena owns a copy of the block of Snapshot
+
+		void clear();
+		//Postcondition: All frequency slots are free, and all End Frequency Slots and Path Distances are 1
+
+		Spectrum_Bitmap occupancy(const int Link, const int Core_Index);
+		const Spectrum_Bitmap occupancy(const int Link, const int Core_Index) const;
+		//Precondition: 0 <= Link < _link_num, Core_Index is 2 * (core - 1) for smaller source to bigger destination 
+		//    and 2 * core - 1 for bigger source to smaller destination
+		//Postcondition: Return the occupancy of the core and direction in the link
+
+		signed char* service_type(const int Link, const int Core_Index);
+		const signed char* service_type(const int Link, const int Core_Index) const;
+		//Precondition: The same as the function occupancy
+		//Postcondition: Return the Service Type of the _slot_num frequency slots of the core and direction in the link, 0 for idle
+
+		int& end_slot(const int Link, const int Core);
+		int end_slot(const int Link, const int Core) const;
+		//Precondition: 0 <= Link < _link_num and 1 <= Core <= _core_num
+		//Postcondition: Return the End Frequency Slot of the core in the link
+
+		int path_distance(const int Link) const;
+		//Precondition: 0 <= Link < _link_num
+		//Postcondition: Return the Path Distance of the link
+
+		void set_path_distance(const int Link, const int Distance);
+		//Precondition: 0 <= Link < _link_num and 1 <= Distance <= max(_slot_num, 1)
+		//Postcondition: The Path Distance of the link is Distance, and the sum and the maximum of the Path Distances have been updated
+
+		int max_path_distance() const;
+		//Postcondition: Return the largest Path Distance over all links, or 0 when there is no link
+
+		long long sum_path_distance() const;
+		//Postcondition: Return the sum of the Path Distances of all links
+
+		void assign(const int Link, const int Core_Index, const int Start, const int Width, const int Service_Type, 
+			const VONELayout::Core_Mask Crosstalk_Mask);
+		//Precondition: The Service Types of the frequency slots from Start to Start + Width - 1 are 0, Service_Type is not 0, 
+		//    and Crosstalk_Mask holds the cores suffering the crosstalk with the core, as given by Core_Layout::crosstalk_mask
+		//Postcondition: The frequency slots have been tagged with Service_Type, and the used slot number and the Crosstalk have been updated. 
+		//    The occupancy is left to the caller
+
+		void unassign(const int Link, const int Core_Index, const int Start, const int Width, const VONELayout::Core_Mask Crosstalk_Mask);
+		//Precondition: The frequency slots from Start to Start + Width - 1 have been assigned with the same Crosstalk_Mask
+		//Postcondition: The Service Types of the frequency slots are 0, and the used slot number and the Crosstalk have been updated. 
+		//    The occupancy is left to the caller
+
+		int highest_used_slot(const int Link, const int Core_Index) const;
+		//Precondition: The same as the function occupancy
+		//Postcondition: Return the Maximum Frequency Slot Index of the core and direction in the link, or 0 if it is idle
+
+		int used_slot_num(const int Link, const int Core_Index) const;
+		//Precondition: The same as the function occupancy
+		//Postcondition: Return the number of the assigned frequency slots of the core and direction in the link
+
+		int fragmentation(const int Link, const int Core_Index) const;
+		//Precondition: The same as the function occupancy
+		//Postcondition: Return the number of the idle frequency slots below the Maximum Frequency Slot Index of the core and direction in the link
+
+		int crosstalk(const int Link) const;
+		//Precondition: 0 <= Link < _link_num
+		//Postcondition: Return the number of the frequency slots in the link sharing the Service Type with the same slot 
+		//    of an adjacent core in the same direction, counting each pair of adjacent cores once
+
+		int get_link_num() const;
+		//Postcondition: Return the number of links _link_num
+
+		int get_core_num() const;
+		//Postcondition: Return the number of cores _core_num
+
+		int get_slot_num() const;
+		//Postcondition: Return the number of frequency slots of each core and direction _slot_num
+
+		const void* data() const;
+		//Postcondition: Return the first byte of the block
+
+		size_t byte_size() const;
+		//Postcondition: Return the number of bytes of the block
+
+		static size_t byte_size(const int Link_Num, const int Core_Num, const int Slot_Num);
+		//Postcondition: Return the number of bytes of the block of an arena with Link_Num links, Core_Num cores and Slot_Num slots
+
+		~Spectrum_Arena();
+
+	private:
+		void layout(const int Link_Num, const int Core_Num, const int Slot_Num);
+		//Postcondition: The sizes and the offsets of the sections in the block have been computed
+
+		int crosstalk_match(const int Link, const int Core_Index, const int Start, const int Width, const VONELayout::Core_Mask Crosstalk_Mask) const;
+		//Precondition: The same as the function assign
+		//Postcondition: Return the contribution of the frequency slots to the Crosstalk of the link, 
+		//    counting the core with each core in Crosstalk_Mask
+
+		int& used_slot_cell(const int Link, const int Core_Index);
+		int& crosstalk_cell(const int Link);
+		int& distance_count_cell(const int Distance);
+		long long& distance_sum_cell();
+		int& distance_max_cell();
+		//Postcondition: Return the counters kept for the functions used_slot_num, crosstalk, sum_path_distance and max_path_distance
+
+		int _link_num;
+		int _core_num;
+		int _slot_num;
+		int _word_num;			//Words of one core and one direction
+		int _free_run_num;		//Nodes of the free run index of one core and one direction
+		size_t _free_run_offset;
+		size_t _end_slot_offset;
+		size_t _path_distance_offset;
+		size_t _distance_count_offset;
+		size_t _used_slot_offset;
+		size_t _crosstalk_offset;
+		size_t _service_type_offset;
+		size_t _distance_total_offset;	//The sum and then the maximum of the Path Distances
+		size_t _byte_size;
+		vector<Spectrum_Word> _storage;
+		Spectrum_Word* _base;	//_storage.data() or the external storage
+	};
+
+	void Shift_And(vector<Spectrum_Word>& Mask, const int Shift);
+	//Precondition: Mask has been assigned, and Shift >= 0
+	//Postcondition: Mask has been replaced by Mask & (Mask >> Shift) across the word boundaries
+
+	void Mask_And(vector<Spectrum_Word>& Mask, const vector<Spectrum_Word>& Other);
+	//Precondition: Mask and Other have the same size
+	//Postcondition: Mask has been replaced by Mask & Other
+
+	void Mask_Or(vector<Spectrum_Word>& Mask, const vector<Spectrum_Word>& Other);
+	//Precondition: Mask and Other have the same size
+	//Postcondition: Mask has been replaced by Mask | Other
+
+	int Lowest_Slot(const vector<Spectrum_Word>& Mask, const int From = 1);
+	//Precondition: Mask has been assigned
+	//Postcondition: Return the smallest frequency slot not smaller than From whose bit is set in Mask, or 0 if there is none
+}
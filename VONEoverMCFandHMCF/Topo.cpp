@@ -7,13 +7,21 @@
 //------------------------------------------------
 
 #include "Topo.h"
+#include "Profiler.h"
 
 #include <iomanip>
 #include <algorithm>
+#include <climits>
+#include <queue>
+#include <functional>
+#include <set>
 
 namespace
 {
 	bool less_edge_id(const VONETopo::Edge& FirstEdge, const VONETopo::Edge& SecondEdge);
+
+	long long Edge_Key(const int Source, const int Destination);
+	//Postcondition: Return the key of the undirected edge between Source and Destination in the edge index
 }
 
 namespace VONETopo
@@ -51,6 +59,7 @@ namespace VONETopo
 	void Topo::AddVertex(const int VertexID, const int Computing_Capacity)
 	{
 		Vertex vertex_tmp = { VertexID, Computing_Capacity };
+		_vertex_index.insert(make_pair(VertexID, static_cast<int>(_vertex.size())));
 		_vertex.push_back(vertex_tmp);
 		_vertex_num = static_cast<int>(_vertex.size());
 	}
@@ -60,16 +69,15 @@ namespace VONETopo
 		NodeListIT Niter_Source, Niter_Destination;
 		if (Source != Destination)
 		{
-			NodeListIT Niter = find_if(_vertex.begin(), _vertex.end(), Vertex_finder(Source));
-			if (Niter != _vertex.end())
+			int Nindex = find_vertex(Source);
+			if (Nindex != -1)
 			{
-				Niter_Source = Niter;
-				Niter = find_if(_vertex.begin(), _vertex.end(), Vertex_finder(Destination));
-				if (Niter != _vertex.end())
+				Niter_Source = _vertex.begin() + Nindex;
+				Nindex = find_vertex(Destination);
+				if (Nindex != -1)
 				{
-					Niter_Destination = Niter;
-					LinkListIT Giter = find_if(_edge.begin(), _edge.end(), Edge_finder(Source, Destination));
-					if (Giter == _edge.end())
+					Niter_Destination = _vertex.begin() + Nindex;
+					if (find_edge(Source, Destination) == -1)
 					{
 						Edge edge;
 						edge._edge_id = _edge_num + 1;
@@ -86,6 +94,7 @@ namespace VONETopo
 							edge._edge_destination = *Niter_Source;
 						}
 
+						_edge_index[Edge_Key(Source, Destination)] = static_cast<int>(_edge.size());
 						_edge.push_back(edge);
 					}
 					else
@@ -129,13 +138,11 @@ namespace VONETopo
 				swap(Start_Capacity, End_Capacity);
 			}
 
-			NodeListIT Niter = find_if(Topology._vertex.begin(), Topology._vertex.end(), Vertex_finder(Start));
-			if (Niter == Topology._vertex.end())
+			if (Topology.find_vertex(Start) == -1)
 			{
 				Topology.AddVertex(Start, Start_Capacity);
 			}
-			Niter = find_if(Topology._vertex.begin(), Topology._vertex.end(), Vertex_finder(End));
-			if (Niter == Topology._vertex.end())
+			if (Topology.find_vertex(End) == -1)
 			{
 				Topology.AddVertex(End, End_Capacity);
 			}
@@ -143,6 +150,7 @@ namespace VONETopo
 			(Topology._edge.end() - 1)->_edge_id = Link_ID;
 		}
 		sort(Topology._edge.begin(), Topology._edge.end(), less_edge_id);
+		Topology.rebuild_edge_index();
 
 		return ins;
 	}
@@ -174,6 +182,37 @@ namespace VONETopo
 		EdgesSet = _edge;
 	}
 
+	int Topo::get_vertex_num() const
+	{
+		return _vertex_num;
+	}
+
+	int Topo::get_edge_num() const
+	{
+		return _edge_num;
+	}
+
+	int Topo::find_vertex(const int VertexID) const
+	{
+		unordered_map<int, int>::const_iterator iter = _vertex_index.find(VertexID);
+		return iter == _vertex_index.end() ? -1 : iter->second;
+	}
+
+	int Topo::find_edge(const int Source, const int Destination) const
+	{
+		unordered_map<long long, int>::const_iterator iter = _edge_index.find(Edge_Key(Source, Destination));
+		return iter == _edge_index.end() ? -1 : iter->second;
+	}
+
+	void Topo::rebuild_edge_index()
+	{
+		_edge_index.clear();
+		for (LinkListIT iter = _edge.begin(); iter != _edge.end(); iter++)
+		{
+			_edge_index[Edge_Key(iter->_edge_source._vertex_id, iter->_edge_destination._vertex_id)] = static_cast<int>(iter - _edge.begin());
+		}
+	}
+
 	Topo::~Topo()
 	{
 
@@ -187,71 +226,86 @@ namespace VONETopo
 	Graph::Graph(const int Vertex_Num, const LinkList& EdgesSet)
 	{
 		_vertex_num = Vertex_Num;
+
+		//Count the degree of each vertex, every undirected edge is stored in both directions:
+		_row_offset.assign(_vertex_num + 1, 0);
+		for (LinkListIT iter = EdgesSet.begin(); iter != EdgesSet.end(); iter++)
+		{
+			_row_offset[(iter->_edge_source)._vertex_id]++;
+			_row_offset[(iter->_edge_destination)._vertex_id]++;
+		}
 		for (int i = 1; i <= _vertex_num; i++)
+			_row_offset[i] += _row_offset[i - 1];
+
+		//Fill the neighbours of each vertex:
+		_adjacent_vertex.resize(_row_offset[_vertex_num]);
+		_adjacent_weight.resize(_row_offset[_vertex_num]);
+		_edge_position.resize(2 * EdgesSet.size());
+		vector<int> fill_index(_row_offset.begin(), _row_offset.end() - 1);
+		for (LinkListIT iter = EdgesSet.begin(); iter != EdgesSet.end(); iter++)
 		{
-			vector<int> row_tmp(_vertex_num, INT_MAX);
-			for (LinkListIT iter = EdgesSet.begin(); iter != EdgesSet.end(); iter++)
-			{
-				if ((iter->_edge_source)._vertex_id == i)
-				{
-					row_tmp[(iter->_edge_destination)._vertex_id - 1] = iter->_edge_bandwidth;
-				}
-				else if ((iter->_edge_destination)._vertex_id == i)
-				{
-					row_tmp[(iter->_edge_source)._vertex_id - 1] = iter->_edge_bandwidth;
-				}
-			}
-			row_tmp[i - 1] = 0;
-			_adjacency_matrix.push_back(row_tmp);
+			int source = (iter->_edge_source)._vertex_id;
+			int destination = (iter->_edge_destination)._vertex_id;
+
+			_edge_position[2 * (iter - EdgesSet.begin())] = fill_index[source - 1];
+			_edge_position[2 * (iter - EdgesSet.begin()) + 1] = fill_index[destination - 1];
+			_adjacent_vertex[fill_index[source - 1]] = destination;
+			_adjacent_weight[fill_index[source - 1]++] = iter->_edge_bandwidth;
+			_adjacent_vertex[fill_index[destination - 1]] = source;
+			_adjacent_weight[fill_index[destination - 1]++] = iter->_edge_bandwidth;
 		}
 	}
 
 	void Graph::Dijkstra(const int Source_ID, const int Destination_ID)
 	{
-		vector <bool> s;
-		vector <int> distance;
-		vector <int> shortest_path_set;
-		for (int i = 1; i <= _vertex_num; i++)
-		{
-			distance.push_back(_adjacency_matrix[Source_ID - 1][i - 1]);
-			s.push_back(false);
-			if (i != Source_ID && distance[i - 1] < INT_MAX)
-				shortest_path_set.push_back(Source_ID);
-			else
-				shortest_path_set.push_back(-1);
-		}
+		Shortest_Path_Tree tree;
+		Search(Source_ID, Destination_ID, tree);
 
-		s[Source_ID - 1] = true;
-		distance[Source_ID - 1] = 0;
-		for (int i = 1; i <= _vertex_num; i++)
+		_distance = tree._distance[Destination_ID - 1];
+		get_shortest_path(tree, Destination_ID, _shortest_path);
+	}
+
+	void Graph::Dijkstra(const int Source_ID, Shortest_Path_Tree& Tree) const
+	{
+		Search(Source_ID, 0, Tree);
+	}
+
+	void Graph::Search(const int Source_ID, const int Destination_ID, Shortest_Path_Tree& Tree, 
+		const vector<bool>* Removed_Vertex, const vector<bool>* Removed_Adjacency) const
+	{
+		VONE_PROFILE_COUNT(VONEProfile::Counter_Dijkstra_Call, 1);
+		vector<bool> s(_vertex_num, false);
+		Tree._source = Source_ID;
+		Tree._distance.assign(_vertex_num, INT_MAX);
+		Tree._predecessor.assign(_vertex_num, -1);
+
+		//Binary heap ordered by distance first and then vertex ID, so that ties are broken towards the smaller ID:
+		priority_queue<pair<int, int>, vector<pair<int, int> >, greater<pair<int, int> > > heap;
+		Tree._distance[Source_ID - 1] = 0;
+		heap.push(make_pair(0, Source_ID));
+		while (!heap.empty())
 		{
-			int min = INT_MAX, u = Source_ID;
-			for (int j = 1; j <= _vertex_num; j++)
-			{
-				if (!s[j - 1] && distance[j - 1] < min)
-				{
-					u = j;
-					min = distance[j - 1];
-				}
-			}
+			int u = heap.top().second;
+			heap.pop();
+			if (s[u - 1])
+				continue;
 			s[u - 1] = true;
-			for (int k = 1; k <= _vertex_num; k++)
+			if (u == Destination_ID)
+				break;
+
+			for (int k = _row_offset[u - 1]; k < _row_offset[u]; k++)
 			{
-				if (!s[k - 1] && _adjacency_matrix[u - 1][k - 1] < INT_MAX
-					&& distance[u - 1] + _adjacency_matrix[u - 1][k - 1] < distance[k - 1])
+				int v = _adjacent_vertex[k];
+				if ((Removed_Vertex != NULL && (*Removed_Vertex)[v - 1]) || (Removed_Adjacency != NULL && (*Removed_Adjacency)[k]))
+					continue;
+				if (!s[v - 1] && Tree._distance[u - 1] + _adjacent_weight[k] < Tree._distance[v - 1])
 				{
-					distance[k - 1] = distance[u - 1] + _adjacency_matrix[u - 1][k - 1];
-					shortest_path_set[k - 1] = u;
+					Tree._distance[v - 1] = Tree._distance[u - 1] + _adjacent_weight[k];
+					Tree._predecessor[v - 1] = u;
+					heap.push(make_pair(Tree._distance[v - 1], v));
 				}
 			}
 		}
-
-		_shortest_path.clear();
-		_distance = distance[Destination_ID - 1];
-		_shortest_path.push_back(Destination_ID);
-		for (int i = 1; shortest_path_set[_shortest_path[i - 1] - 1] != -1; i++)
-			_shortest_path.push_back(shortest_path_set[_shortest_path[i - 1] - 1]);
-		reverse(_shortest_path.begin(), _shortest_path.end());
 	}
 
 	void Graph::get_shortest_path(vector<int>& Shortest_Path) const
@@ -264,10 +318,98 @@ namespace VONETopo
 		return _distance;
 	}
 
+	void Graph::set_edge_weight(const int Edge_Index, const int Weight)
+	{
+		_adjacent_weight[_edge_position[2 * Edge_Index]] = Weight;
+		_adjacent_weight[_edge_position[2 * Edge_Index + 1]] = Weight;
+	}
+
+	void Graph::get_shortest_path(const Shortest_Path_Tree& Tree, const int Destination_ID, vector<int>& Shortest_Path)
+	{
+		Shortest_Path.clear();
+		Shortest_Path.push_back(Destination_ID);
+		for (int i = 1; Tree._predecessor[Shortest_Path[i - 1] - 1] != -1; i++)
+			Shortest_Path.push_back(Tree._predecessor[Shortest_Path[i - 1] - 1]);
+		reverse(Shortest_Path.begin(), Shortest_Path.end());
+	}
+
+	void Graph::K_Shortest_Paths(const int Source_ID, const int Destination_ID, const int K, vector<vector<int> >& Paths) const
+	{
+		Paths.clear();
+		Shortest_Path_Tree tree;
+		Search(Source_ID, Destination_ID, tree);
+		if (tree._distance[Destination_ID - 1] == INT_MAX)
+			return;
+		vector<int> path;
+		get_shortest_path(tree, Destination_ID, path);
+		path.push_back(tree._distance[Destination_ID - 1]);
+		Paths.push_back(path);
+
+		//The candidates are ordered by distance and then by the vertexes, so that equal distances are taken in a fixed order:
+		set<pair<int, vector<int> > > candidate;
+		vector<bool> removed_vertex(_vertex_num, false);
+		vector<bool> removed_adjacency(_adjacent_vertex.size(), false);
+		for (int k = 1; k < K; k++)
+		{
+			const vector<int>& last_path = Paths[k - 1];
+			int last_length = static_cast<int>(last_path.size()) - 1;		//The distance is the last element
+			int root_distance = 0;
+			for (int i = 0; i < last_length - 1; i++)
+			{
+				//The spur path leaves the root path at its vertex i, avoiding the next hops of the found paths sharing the root
+				//    and the vertexes of the root before it:
+				int spur = last_path[i];
+				for (vector<vector<int> >::const_iterator piter = Paths.begin(); piter != Paths.end(); piter++)
+				{
+					if (static_cast<int>(piter->size()) - 1 > i + 1 && equal(last_path.begin(), last_path.begin() + i + 1, piter->begin()))
+					{
+						int position = adjacency((*piter)[i], (*piter)[i + 1]);
+						removed_adjacency[position] = true;
+					}
+				}
+				for (int j = 0; j < i; j++)
+					removed_vertex[last_path[j] - 1] = true;
+
+				Search(spur, Destination_ID, tree, &removed_vertex, &removed_adjacency);
+				if (tree._distance[Destination_ID - 1] != INT_MAX)
+				{
+					vector<int> spur_path;
+					get_shortest_path(tree, Destination_ID, spur_path);
+					path.assign(last_path.begin(), last_path.begin() + i);
+					path.insert(path.end(), spur_path.begin(), spur_path.end());
+					path.push_back(root_distance + tree._distance[Destination_ID - 1]);
+					candidate.insert(make_pair(path.back(), path));
+				}
+
+				fill(removed_vertex.begin(), removed_vertex.end(), false);
+				fill(removed_adjacency.begin(), removed_adjacency.end(), false);
+				root_distance += _adjacent_weight[adjacency(spur, last_path[i + 1])];
+			}
+
+			//The next path is the best candidate not found yet:
+			while (!candidate.empty() && find(Paths.begin(), Paths.end(), candidate.begin()->second) != Paths.end())
+				candidate.erase(candidate.begin());
+			if (candidate.empty())
+				break;
+			Paths.push_back(candidate.begin()->second);
+			candidate.erase(candidate.begin());
+		}
+	}
+
 	Graph::~Graph()
 	{
 
 	}
+
+	int Graph::adjacency(const int Source_ID, const int Destination_ID) const
+	{
+		for (int k = _row_offset[Source_ID - 1]; k < _row_offset[Source_ID]; k++)
+		{
+			if (_adjacent_vertex[k] == Destination_ID)
+				return k;
+		}
+		return -1;
+	}
 }
 
 namespace
@@ -276,4 +418,10 @@ namespace
 	{
 		return FirstEdge._edge_id < SecondEdge._edge_id;
 	}
+
+	long long Edge_Key(const int Source, const int Destination)
+	{
+		return Source < Destination ? (static_cast<long long>(Source) << 32) | static_cast<unsigned int>(Destination)
+			: (static_cast<long long>(Destination) << 32) | static_cast<unsigned int>(Source);
+	}
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #pragma once
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 
 using namespace std;
 
@@ -94,16 +95,44 @@ namespace VONETopo
 		//Precondition: the topology has been assigned
 		//Postcondition: return the topology _edge
 
+		int get_vertex_num() const;
+		//Postcondition: return the number of vertexes _vertex_num without copying _vertex
+
+		int get_edge_num() const;
+		//Postcondition: return the number of edges _edge_num without copying _edge
+
+		int find_vertex(const int VertexID) const;
+		//Precondition: the topology has been assigned
+		//Postcondition: return the index of the Vertex VertexID in _vertex, or -1 if it is not defined
+
+		int find_edge(const int Source, const int Destination) const;
+		//Precondition: the topology has been assigned
+		//Postcondition: return the index of the Edge between Source and Destination in _edge regardless of 
+		//    the direction, or -1 if it is not defined
+
 		~Topo();
 
 	private:
+		void rebuild_edge_index();
+		//Postcondition: _edge_index has been rebuilt from the current order of _edge
+
 		NodeList _vertex;
 		int _vertex_num;
 		int _edge_num;
 		LinkList _edge;
+		unordered_map<int, int> _vertex_index;			//Vertex ID -> index in _vertex
+		unordered_map<long long, int> _edge_index;		//(smaller vertex ID, bigger vertex ID) -> index in _edge
+	};
+
+	//The shortest path tree rooted at one source vertex, each vertex includes two properties: Distance and Predecessor
+	struct Shortest_Path_Tree
+	{
+		int _source;
+		vector<int> _distance;
+		vector<int> _predecessor;
 	};
 
-	//Create weighted directed Graph of the Topology resource
+	//Create weighted directed Graph of the Topology resource, the adjacency is stored in compressed sparse row (CSR) form
 	class Graph
 	{
 	public:
@@ -111,13 +140,17 @@ namespace VONETopo
 
 		Graph(const int Vertex_Num, const LinkList& EdgesSet);
 		//Precondition: the topology has been assigned
-		//Postcondition: the adjacent matrix of the topology has been built and put in _adjacency_matrix
+		//Postcondition: the adjacency of the topology has been built and put in _row_offset, _adjacent_vertex and _adjacent_weight
 
 		void Dijkstra(const int Source_ID, const int Destination_ID);
-		//Precondition: the _adjacency_matrix has been assigned
+		//Precondition: the adjacency has been assigned
 		//Postcondition: the shortest path from Source_ID to Destination_ID has been found and put in _shortest_path,
 		//    its distance has been put in _distance, too
 
+		void Dijkstra(const int Source_ID, Shortest_Path_Tree& Tree) const;
+		//Precondition: the adjacency has been assigned
+		//Postcondition: the shortest paths from Source_ID to all vertexes have been found and put in Tree
+
 		void get_shortest_path(vector<int>& Shortest_Path) const;
 		//Precondition: the function Dijkstra has been executed, and _shortest_path has been assigned
 		//Postcondition: return the shortest path _shortest_path
@@ -126,11 +159,38 @@ namespace VONETopo
 		//Precondition: the function Dijkstra has been executed, and _distance has been assigned
 		//Postcondition: return the distance of the shortest path _distance
 
+		void set_edge_weight(const int Edge_Index, const int Weight);
+		//Precondition: Edge_Index is the index of the edge in the EdgesSet which built the graph
+		//Postcondition: the weight of the edge has been updated in both directions without rebuilding the adjacency
+
+		static void get_shortest_path(const Shortest_Path_Tree& Tree, const int Destination_ID, vector<int>& Shortest_Path);
+		//Precondition: the function Dijkstra has built Tree
+		//Postcondition: return the shortest path from the root of Tree to Destination_ID
+
+		void K_Shortest_Paths(const int Source_ID, const int Destination_ID, const int K, vector<vector<int> >& Paths) const;
+		//Precondition: the adjacency has been assigned, Source_ID != Destination_ID and K >= 1
+		//Postcondition: the K shortest loopless paths from Source_ID to Destination_ID have been found by Yen's algorithm 
+		//    and put in Paths in the order of distance, each followed by its distance, fewer paths are put when there are not so many
+
 		~Graph();
 
 	private:
+		void Search(const int Source_ID, const int Destination_ID, Shortest_Path_Tree& Tree, 
+			const vector<bool>* Removed_Vertex = NULL, const vector<bool>* Removed_Adjacency = NULL) const;
+		//Precondition: the adjacency has been assigned, Removed_Vertex is NULL or has _vertex_num entries 
+		//    and Removed_Adjacency is NULL or has an entry for each entry of _adjacent_vertex
+		//Postcondition: Tree has been grown from Source_ID until Destination_ID is settled, or over all vertexes when Destination_ID is 0, 
+		//    without entering the removed vertexes or following the removed adjacency entries
+
+		int adjacency(const int Source_ID, const int Destination_ID) const;
+		//Precondition: the adjacency has been assigned
+		//Postcondition: return the position of Destination_ID among the neighbours of Source_ID in _adjacent_vertex, or -1 if they are not adjacent
+
 		int _vertex_num;
-		vector<vector<int> > _adjacency_matrix;
+		vector<int> _row_offset;		//Vertex i's neighbours are in [_row_offset[i - 1], _row_offset[i])
+		vector<int> _adjacent_vertex;
+		vector<int> _adjacent_weight;
+		vector<int> _edge_position;		//Edge i is stored at _edge_position[2 * i] and _edge_position[2 * i + 1]
 		int _distance;
 		vector<int> _shortest_path;
 	};
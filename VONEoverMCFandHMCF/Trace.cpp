@@ -0,0 +1,259 @@
+//This file defines class trace reader and trace writer of the virtual network requests.
+//------------------------------------------------
+//File Name: Trace.cpp
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#include "Trace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <iomanip>
+
+namespace
+{
+	const int Trace_Version = 1;
+
+	bool Parse_Integer(const char*& Cursor, int& Number);
+	//Postcondition: Number has been parsed from Cursor after the blanks, which has been moved past it, and return false when there is none
+
+	bool Parse_Double(const char*& Cursor, double& Number);
+	//Postcondition: The same as the function Parse_Integer for a floating point Number
+}
+
+namespace VONETrace
+{
+	Trace_Reader::Trace_Reader(const string& File_Name) : _file_name(File_Name), _format(Text_Trace), _line_num(0), _request_num(0)
+	{
+		_file.open(File_Name.c_str(), ios::in | ios::binary);
+		if (_file.fail())
+		{
+			cerr << "File " << File_Name << " opening failed.\n";
+			exit(1);
+		}
+
+		//The binary trace is told by its magic, and the text trace is read again from the beginning otherwise:
+		char magic[4] = { 0, 0, 0, 0 };
+		_file.read(magic, sizeof(magic));
+		if (_file.gcount() == sizeof(magic) && memcmp(magic, "VONT", sizeof(magic)) == 0)
+		{
+			int version = 0;
+			_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+			if (!_file || version != Trace_Version)
+				fail("Unknown version of the binary trace");
+			_format = Binary_Trace;
+		}
+		else
+		{
+			_file.clear();
+			_file.seekg(0);
+		}
+	}
+
+	bool Trace_Reader::next(Trace_Request& Request)
+	{
+		bool found = (_format == Text_Trace) ? next_text(Request) : next_binary(Request);
+		if (found)
+			_request_num++;
+		return found;
+	}
+
+	Trace_Format Trace_Reader::get_format() const
+	{
+		return _format;
+	}
+
+	long long Trace_Reader::get_request_num() const
+	{
+		return _request_num;
+	}
+
+	Trace_Reader::~Trace_Reader()
+	{
+		_file.close();
+	}
+
+	bool Trace_Reader::next_text(Trace_Request& Request)
+	{
+		//Skip the blank lines and the comments:
+		const char* cursor = NULL;
+		while (true)
+		{
+			if (!getline(_file, _line))
+				return false;
+			_line_num++;
+			cursor = _line.c_str();
+			while (isspace(static_cast<unsigned char>(*cursor)))
+				cursor++;
+			if (*cursor != '\0' && *cursor != '#')
+				break;
+		}
+
+		int node_num = 0, link_num = 0;
+		if (!Parse_Double(cursor, Request._arrival_time) || !Parse_Double(cursor, Request._holding_time) || !Parse_Integer(cursor, node_num) || node_num < 1)
+			fail("The arrival time, the holding time or the node number is missing");
+
+		Request._topology = VONETopo::Topo();
+		for (int node = 1; node <= node_num; node++)
+		{
+			int cpu = 0;
+			if (!Parse_Integer(cursor, cpu))
+				fail("The CPU of a node is missing");
+			Request._topology.AddVertex(node, cpu);
+		}
+
+		if (!Parse_Integer(cursor, link_num) || link_num < 1)
+			fail("The link number is missing");
+		for (int link = 1; link <= link_num; link++)
+		{
+			int source = 0, destination = 0, bandwidth = 0;
+			if (!Parse_Integer(cursor, source) || !Parse_Integer(cursor, destination) || !Parse_Integer(cursor, bandwidth))
+				fail("The source, the destination or the bandwidth of a link is missing");
+			if (source < 1 || source > node_num || destination < 1 || destination > node_num)
+				fail("A link ends at an undefined node");
+			Request._topology.AddEdge(source, destination, bandwidth);
+		}
+
+		while (isspace(static_cast<unsigned char>(*cursor)))
+			cursor++;
+		if (*cursor != '\0')
+			fail("There are extra fields after the links");
+		return true;
+	}
+
+	bool Trace_Reader::next_binary(Trace_Request& Request)
+	{
+		double time[2];
+		_file.read(reinterpret_cast<char*>(time), sizeof(time));
+		if (_file.gcount() == 0 && _file.eof())
+			return false;
+
+		int node_num = 0, link_num = 0;
+		_file.read(reinterpret_cast<char*>(&node_num), sizeof(node_num));
+		if (!_file || node_num < 1)
+			fail("The request is truncated or has no node");
+		Request._arrival_time = time[0];
+		Request._holding_time = time[1];
+
+		Request._topology = VONETopo::Topo();
+		_field.resize(node_num);
+		_file.read(reinterpret_cast<char*>(_field.data()), node_num * sizeof(int));
+		_file.read(reinterpret_cast<char*>(&link_num), sizeof(link_num));
+		if (!_file || link_num < 1)
+			fail("The request is truncated or has no link");
+		for (int node = 1; node <= node_num; node++)
+			Request._topology.AddVertex(node, _field[node - 1]);
+
+		_field.resize(3 * link_num);
+		_file.read(reinterpret_cast<char*>(_field.data()), 3 * link_num * sizeof(int));
+		if (!_file)
+			fail("The request is truncated");
+		for (int link = 0; link < link_num; link++)
+		{
+			int source = _field[3 * link], destination = _field[3 * link + 1];
+			if (source < 1 || source > node_num || destination < 1 || destination > node_num)
+				fail("A link ends at an undefined node");
+			Request._topology.AddEdge(source, destination, _field[3 * link + 2]);
+		}
+		return true;
+	}
+
+	void Trace_Reader::fail(const char* Reason) const
+	{
+		cerr << Reason << " in ";
+		if (_format == Text_Trace)
+			cerr << "line " << _line_num;
+		else
+			cerr << "request " << _request_num + 1;
+		cerr << " of the trace " << _file_name << "!\n";
+		exit(1);
+	}
+
+	Trace_Writer::Trace_Writer(const string& File_Name, const Trace_Format Format) : _format(Format)
+	{
+		_file.open(File_Name.c_str(), Format == Binary_Trace ? ios::out | ios::binary : ios::out);
+		if (_file.fail())
+		{
+			cerr << "File " << File_Name << " opening failed.\n";
+			exit(1);
+		}
+
+		if (_format == Binary_Trace)
+		{
+			_file.write("VONT", 4);
+			_file.write(reinterpret_cast<const char*>(&Trace_Version), sizeof(Trace_Version));
+		}
+		else
+		{
+			//The times are written exactly, so that the text trace replays the same as the binary one:
+			_file << setprecision(17);
+			_file << "#<arrival time> <holding time> <node number> <CPU of each node> <link number> <source> <destination> <bandwidth> of each link\n";
+		}
+	}
+
+	void Trace_Writer::write(const Trace_Request& Request)
+	{
+		VONETopo::NodeList Node;
+		VONETopo::LinkList Link;
+		Request._topology.get_vertex(Node);
+		Request._topology.get_edge(Link);
+
+		if (_format == Binary_Trace)
+		{
+			double time[2] = { Request._arrival_time, Request._holding_time };
+			_file.write(reinterpret_cast<const char*>(time), sizeof(time));
+			int node_num = static_cast<int>(Node.size()), link_num = static_cast<int>(Link.size());
+			_file.write(reinterpret_cast<const char*>(&node_num), sizeof(node_num));
+			for (VONETopo::NodeListIT iter = Node.begin(); iter != Node.end(); iter++)
+				_file.write(reinterpret_cast<const char*>(&iter->_vertex_computing_capacity), sizeof(int));
+			_file.write(reinterpret_cast<const char*>(&link_num), sizeof(link_num));
+			for (VONETopo::LinkListIT iter = Link.begin(); iter != Link.end(); iter++)
+			{
+				int field[3] = { iter->_edge_source._vertex_id, iter->_edge_destination._vertex_id, iter->_edge_bandwidth };
+				_file.write(reinterpret_cast<const char*>(field), sizeof(field));
+			}
+			return;
+		}
+
+		_file << Request._arrival_time << " " << Request._holding_time << " " << Node.size();
+		for (VONETopo::NodeListIT iter = Node.begin(); iter != Node.end(); iter++)
+			_file << " " << iter->_vertex_computing_capacity;
+		_file << " " << Link.size();
+		for (VONETopo::LinkListIT iter = Link.begin(); iter != Link.end(); iter++)
+			_file << " " << iter->_edge_source._vertex_id << " " << iter->_edge_destination._vertex_id << " " << iter->_edge_bandwidth;
+		_file << "\n";
+	}
+
+	Trace_Writer::~Trace_Writer()
+	{
+		_file.close();
+	}
+}
+
+namespace
+{
+	bool Parse_Integer(const char*& Cursor, int& Number)
+	{
+		char* end = NULL;
+		long value = strtol(Cursor, &end, 10);
+		if (end == Cursor)
+			return false;
+		Number = static_cast<int>(value);
+		Cursor = end;
+		return true;
+	}
+
+	bool Parse_Double(const char*& Cursor, double& Number)
+	{
+		char* end = NULL;
+		double value = strtod(Cursor, &end);
+		if (end == Cursor)
+			return false;
+		Number = value;
+		Cursor = end;
+		return true;
+	}
+}
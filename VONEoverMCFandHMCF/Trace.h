@@ -0,0 +1,91 @@
+//This file declares class trace reader and trace writer of the virtual network requests.
+//------------------------------------------------
+//File Name: Trace.h
+//Author: Qihan Zhang
+//Email: lengkudaodi@outlook.com
+//Last Modified: Oct. 17th 2026
+//------------------------------------------------
+
+#pragma once
+#include "Topo.h"
+
+#include <fstream>
+#include <string>
+
+namespace VONETrace
+{
+	//One virtual network request of a trace, which departs _holding_time after it arrives, or never when _holding_time <= 0
+	struct Trace_Request
+	{
+		double _arrival_time;
+		double _holding_time;
+		VONETopo::Topo _topology;
+	};
+
+	//The formats of a trace. The text trace holds one request per line as
+	//    <arrival time> <holding time> <node number> <CPU of each node> <link number> <source> <destination> <bandwidth> of each link,
+	//    where the nodes are numbered from 1 and the lines beginning with # are comments. The binary trace begins with the magic "VONT"
+	//    and the version 1, and holds each request as two doubles and 32-bit integers in the same order, in the native byte order
+	enum Trace_Format
+	{
+		Text_Trace,
+		Binary_Trace
+	};
+
+	//Create the reader, which streams the requests of a trace one by one,
+	//    so that only the request being read is held in memory however long the trace is
+	class Trace_Reader
+	{
+	public:
+		Trace_Reader(const string& File_Name);
+		//Postcondition: The trace File_Name has been opened, whose format is told by its magic
+
+		bool next(Trace_Request& Request);
+		//Postcondition: Request has been replaced by the next request of the trace, and return false when the trace has ended.
+		//    The program exits when the request is malformed
+
+		Trace_Format get_format() const;
+		//Postcondition: Return the format of the trace
+
+		long long get_request_num() const;
+		//Postcondition: Return the number of the requests read so far
+
+		~Trace_Reader();
+
+	private:
+		bool next_text(Trace_Request& Request);
+		//Postcondition: The same as the function next for the text trace
+
+		bool next_binary(Trace_Request& Request);
+		//Postcondition: The same as the function next for the binary trace
+
+		void fail(const char* Reason) const;
+		//Postcondition: The program exits with Reason and the position of the current request
+
+		string _file_name;
+		ifstream _file;
+		Trace_Format _format;
+		long long _line_num;			//The lines read so far of the text trace
+		long long _request_num;
+		string _line;					//The current line of the text trace, kept to reuse its storage
+		vector<int> _field;				//The integers of the current binary request, kept to reuse their storage
+	};
+
+	//Create the writer, which appends the requests to a trace, to record the generated requests or to convert a trace into the other format
+	class Trace_Writer
+	{
+	public:
+		Trace_Writer(const string& File_Name, const Trace_Format Format);
+		//Postcondition: The trace File_Name has been created in Format
+
+		void write(const Trace_Request& Request);
+		//Precondition: The nodes of Request._topology are numbered from 1
+		//Postcondition: Request has been appended to the trace
+
+		~Trace_Writer();
+
+	private:
+		ofstream _file;
+		Trace_Format _format;
+	};
+}
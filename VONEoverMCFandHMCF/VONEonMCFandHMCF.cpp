@@ -8,6 +8,12 @@
 
 #include "ILP.h"
 #include "Heuristic.h"
+#include "Simulator.h"
+#include "Result.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <sstream>
 
 namespace
 {
@@ -23,13 +29,55 @@ namespace
 //-3: The topology input file fails to read when the argument "Input" has been set, check the file opened code;
 //-4: The argument "HeterogeneousCoreIndex" should be a non-negetive integer, check the input parameter;
 //-5: The argument "CrosstalkYesorNo" should be one of the strings as following: Yes, yes No or no;
-//-6: The argument "Solver" should be one of the strings as following: ILP, Heuristic or ILPHeuristic;
-//-7: The result file failed to open.
+//-6: The argument "Solver" should be one of the strings as following: ILP, Heuristic, ILPHeuristic, Multistart, Anytime, Concurrent, Parallel or Dynamic;
+//-7: The result file failed to open;
+//-8: The solver "Dynamic" needs the argument "Erlang" or "Trace".
 
 int main(int argc, char **argv)
 {
 	int ServiceRequestNumber, CoreNumber, HeterogeneousCoreIndex, MainError;
 	string TypeofTopology, TopoFilename, CrosstalkYesorNo, Solver;
+
+	//The options of the solvers after Heuristic may follow the arguments above in any order, 
+	//    and they are taken out before the arguments above are counted:
+	int ThreadNumber = 0, StartNumber = 8, PathNumber = 0;
+	long long WarmupNumber = 0;
+	double TimeBudget = 1000, HoldingTime = 1, DefragmentationBudget = 0;
+	unsigned int Seed = 1;
+	string ErlangLoad, TraceFilename;
+	vector<char*> Argument(1, argv[0]);
+	for (int i = 2; i <= argc; i++)
+	{
+		if (i < argc && ((strcmp(argv[i - 1], "-thread") == 0) || (strcmp(argv[i - 1], "-n") == 0)))
+			ThreadNumber = stoi(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-start") == 0) || (strcmp(argv[i - 1], "-m") == 0)))
+			StartNumber = stoi(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-budget") == 0) || (strcmp(argv[i - 1], "-b") == 0)))
+			TimeBudget = stod(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-seed") == 0) || (strcmp(argv[i - 1], "-d") == 0)))
+			Seed = static_cast<unsigned int>(stoul(argv[i + 1 - 1]));
+		else if (i < argc && ((strcmp(argv[i - 1], "-kpath") == 0) || (strcmp(argv[i - 1], "-k") == 0)))
+			PathNumber = stoi(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-erlang") == 0) || (strcmp(argv[i - 1], "-e") == 0)))
+			ErlangLoad = argv[i + 1 - 1];
+		else if (i < argc && ((strcmp(argv[i - 1], "-holding") == 0) || (strcmp(argv[i - 1], "-o") == 0)))
+			HoldingTime = stod(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-warmup") == 0) || (strcmp(argv[i - 1], "-w") == 0)))
+			WarmupNumber = stoll(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-defrag") == 0) || (strcmp(argv[i - 1], "-g") == 0)))
+			DefragmentationBudget = stod(argv[i + 1 - 1]);
+		else if (i < argc && ((strcmp(argv[i - 1], "-trace") == 0) || (strcmp(argv[i - 1], "-f") == 0)))
+			TraceFilename = argv[i + 1 - 1];
+		else
+		{
+			Argument.push_back(argv[i - 1]);
+			continue;
+		}
+		i++;
+	}
+	argc = static_cast<int>(Argument.size());
+	argv = Argument.data();
+
 	switch (argc)
 	{
 	case 1:
@@ -256,13 +304,24 @@ int main(int argc, char **argv)
 		ResultFileName = ResultFileName + "Heuristic";
 	else if (Solver == "ILPHeuristic")
 		ResultFileName = ResultFileName + "ILPHeuristic";
+	else if ((Solver == "Multistart") || (Solver == "Anytime") || (Solver == "Concurrent") || (Solver == "Parallel") || (Solver == "Dynamic"))
+		ResultFileName = ResultFileName + Solver;
 	else
 	{
-		cerr << "Wrong Solver has been given, right Solver should be ILP, Heuristic or ILPHeuristic!\n";
+		cerr << "Wrong Solver has been given, right Solver should be ILP, Heuristic, ILPHeuristic, "
+			<< "Multistart, Anytime, Concurrent, Parallel or Dynamic!\n";
 		MainError = -6;
 	}
 
+	if (Solver == "Dynamic" && ErlangLoad.empty() && TraceFilename.empty())
+	{
+		cerr << "The solver Dynamic needs the Erlang loads or a trace!\n";
+		MainError = -8;
+		exit(1);
+	}
+
 	ofstream fout;
+	string RecordFileName = ResultFileName + to_string(ServiceRequestNumber) + "Record.csv";
 	ResultFileName = ResultFileName + to_string(ServiceRequestNumber) + "Result.txt";
 	fout.open(ResultFileName.c_str()); //Use result file to record some information
 	if (fout.fail())
@@ -272,12 +331,12 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
-	cout << Substrate_Network << endl;
-	fout << Substrate_Network << endl;
+	cout << Substrate_Network << "\n";
+	fout << Substrate_Network << "\n";
 
-	//Input the Virtual Network:
+	//Input the Virtual Network, which the solver Dynamic generates by itself:
 	vector<VONETopo::Topo> Virtual_Network_List;
-	for (int i = 1; i <= ServiceRequestNumber; i++)
+	for (int i = 1; i <= ServiceRequestNumber && Solver != "Dynamic"; i++)
 	{
 		VONETopo::Topo VN_tmp;
 
@@ -317,12 +376,12 @@ int main(int argc, char **argv)
 		Virtual_Network_List.push_back(VN_tmp);
 	}
 
-	for (int i = 1; i <= ServiceRequestNumber; i++)
+	for (int i = 1; i <= static_cast<int>(Virtual_Network_List.size()); i++)
 	{
 		cout << "The Virtual Request Topology " << i << " are following:\n";
-		cout << Virtual_Network_List[i - 1] << endl;
+		cout << Virtual_Network_List[i - 1] << "\n";
 		fout << "The Virtual Request Topology " << i << " are following:\n";
-		fout << Virtual_Network_List[i - 1] << endl;
+		fout << Virtual_Network_List[i - 1] << "\n";
 	}
 
 	if (Solver == "ILP")
@@ -330,28 +389,51 @@ int main(int argc, char **argv)
 		//Solve the ILP of VONE:
 		VONEILP::VONECplex Solve_VONE_on_MCF_of_ILP;
 		//Time count:
-		clock_t start = clock();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
 		Solve_VONE_on_MCF_of_ILP.solve(Substrate_Network, Virtual_Network_List, 
 			CoreNumber, HeterogeneousCoreIndex, CrosstalkYesorNo);
-		clock_t end = clock();
-		fout << "\nThe running time of ILP is: " << static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		cout << "\nThe running time of ILP is: " << static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		fout << Solve_VONE_on_MCF_of_ILP << endl;
-		cout << Solve_VONE_on_MCF_of_ILP << endl;
+		double running_time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		fout << "\nThe running time of ILP is: " << running_time << "ms\n\n";
+		cout << "\nThe running time of ILP is: " << running_time << "ms\n\n";
+		fout << Solve_VONE_on_MCF_of_ILP << "\n";
+		cout << Solve_VONE_on_MCF_of_ILP << "\n";
 	}		
-	else if (Solver == "Heuristic")
+	else if ((Solver == "Heuristic") || (Solver == "Multistart") || (Solver == "Anytime") || (Solver == "Concurrent") || (Solver == "Parallel"))
 	{
 		//Solve the Heuristic of VONE:
 		VONEHeuristic::VONEHeuristic Solve_VONE_on_MCF_of_Heuristic;
+		if (PathNumber > 0)
+			Solve_VONE_on_MCF_of_Heuristic.set_path_candidate_num(PathNumber);
+		//The record of each virtual network is kept in the CSV sink during the solve, and written after the time count:
+		VONEResult::CSV_Sink Record_Sink(RecordFileName);
+		Record_Sink.set_deferred(true);
+		Solve_VONE_on_MCF_of_Heuristic.set_result_sink(&Record_Sink);
 		//Time count:
-		clock_t start = clock();
-		Solve_VONE_on_MCF_of_Heuristic.solve(Substrate_Network, Virtual_Network_List, 
-			CoreNumber, HeterogeneousCoreIndex, CrosstalkYesorNo);
-		clock_t end = clock();
-		fout << "The running time of Heuristic is: " << static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		cout << "The running time of Heuristic is: " << static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		fout << Solve_VONE_on_MCF_of_Heuristic << endl;
-		cout << Solve_VONE_on_MCF_of_Heuristic << endl;		
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if (Solver == "Heuristic")
+			Solve_VONE_on_MCF_of_Heuristic.solve(Substrate_Network, Virtual_Network_List, 
+				CoreNumber, HeterogeneousCoreIndex, CrosstalkYesorNo);
+		else if (Solver == "Multistart")
+			Solve_VONE_on_MCF_of_Heuristic.solve_multistart(Substrate_Network, Virtual_Network_List, 
+				VONELayout::Core_Layout(CoreNumber), HeterogeneousCoreIndex, CrosstalkYesorNo, StartNumber, ThreadNumber, Seed);
+		else if (Solver == "Anytime")
+			Solve_VONE_on_MCF_of_Heuristic.solve_anytime(Substrate_Network, Virtual_Network_List, 
+				VONELayout::Core_Layout(CoreNumber), HeterogeneousCoreIndex, CrosstalkYesorNo, TimeBudget, Seed);
+		else if (Solver == "Concurrent")
+			Solve_VONE_on_MCF_of_Heuristic.solve_concurrent(Substrate_Network, Virtual_Network_List, 
+				VONELayout::Core_Layout(CoreNumber), HeterogeneousCoreIndex, CrosstalkYesorNo, ThreadNumber);
+		else
+			Solve_VONE_on_MCF_of_Heuristic.solve_parallel(Substrate_Network, Virtual_Network_List, 
+				VONELayout::Core_Layout(CoreNumber), HeterogeneousCoreIndex, CrosstalkYesorNo, ThreadNumber);
+		double running_time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		Record_Sink.flush();
+		fout << "The running time of " << Solver << " is: " << running_time << "ms\n\n";
+		cout << "The running time of " << Solver << " is: " << running_time << "ms\n\n";
+#ifdef VONE_PROFILE
+		VONEProfile::Report(fout);
+#endif
+		//The report is only written into the result file, and the frequency slots of each core are left out of it:
+		fout << Solve_VONE_on_MCF_of_Heuristic << "\n";		
 	}
 	else if (Solver == "ILPHeuristic")
 	{
@@ -360,26 +442,61 @@ int main(int argc, char **argv)
 		//Solve the ILP of VONE:
 		VONEILP::VONECplex Solve_VONE_on_MCF_of_ILP;
 		//Time count:
-		clock_t ILP_start = clock();
+		chrono::steady_clock::time_point ILP_start = chrono::steady_clock::now();
 		Solve_VONE_on_MCF_of_ILP.solve(Substrate_Network, Virtual_Network_List,
 			CoreNumber, HeterogeneousCoreIndex, CrosstalkYesorNo);
-		clock_t ILP_end = clock();
-		fout << "\nThe running time of ILP is: " << static_cast<double>(ILP_end - ILP_start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		cout << "\nThe running time of ILP is: " << static_cast<double>(ILP_end - ILP_start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		fout << Solve_VONE_on_MCF_of_ILP << endl;
-		cout << Solve_VONE_on_MCF_of_ILP << endl;
+		double ILP_running_time = chrono::duration<double, milli>(chrono::steady_clock::now() - ILP_start).count();
+		fout << "\nThe running time of ILP is: " << ILP_running_time << "ms\n\n";
+		cout << "\nThe running time of ILP is: " << ILP_running_time << "ms\n\n";
+		fout << Solve_VONE_on_MCF_of_ILP << "\n";
+		cout << Solve_VONE_on_MCF_of_ILP << "\n";
 
 		//Solve the Heuristic of VONE:
 		VONEHeuristic::VONEHeuristic Solve_VONE_on_MCF_of_Heuristic;
+		//The record of each virtual network is kept in the CSV sink during the solve, and written after the time count:
+		VONEResult::CSV_Sink Record_Sink(RecordFileName);
+		Record_Sink.set_deferred(true);
+		Solve_VONE_on_MCF_of_Heuristic.set_result_sink(&Record_Sink);
 		//Time count:
-		clock_t Heuristic_start = clock();
+		chrono::steady_clock::time_point Heuristic_start = chrono::steady_clock::now();
 		Solve_VONE_on_MCF_of_Heuristic.solve(Substrate_Network, Virtual_Network_List,
 			CoreNumber, HeterogeneousCoreIndex, CrosstalkYesorNo);
-		clock_t Heuristic_end = clock();
-		fout << "The running time of Heuristic is: " << static_cast<double>(Heuristic_end - Heuristic_start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		cout << "The running time of Heuristic is: " << static_cast<double>(Heuristic_end - Heuristic_start) / CLOCKS_PER_SEC * 1000 << "ms\n\n";
-		fout << Solve_VONE_on_MCF_of_Heuristic << endl;
-		cout << Solve_VONE_on_MCF_of_Heuristic << endl;
+		double Heuristic_running_time = chrono::duration<double, milli>(chrono::steady_clock::now() - Heuristic_start).count();
+		Record_Sink.flush();
+		fout << "The running time of Heuristic is: " << Heuristic_running_time << "ms\n\n";
+		cout << "The running time of Heuristic is: " << Heuristic_running_time << "ms\n\n";
+#ifdef VONE_PROFILE
+		VONEProfile::Report(fout);
+#endif
+		//The report is only written into the result file, and the frequency slots of each core are left out of it:
+		fout << Solve_VONE_on_MCF_of_Heuristic << "\n";
+	}
+	else if (Solver == "Dynamic")
+	{
+		//Simulate the dynamic traffic, with the random virtual networks under each Erlang load, or with the requests of the trace:
+		VONESimulator::Dynamic_Simulator Simulate_VONE_on_MCF(Substrate_Network, VONELayout::Core_Layout(CoreNumber), 
+			HeterogeneousCoreIndex, CrosstalkYesorNo, Seed);
+		Simulate_VONE_on_MCF.set_path_candidate_num(PathNumber);
+		Simulate_VONE_on_MCF.set_defragmentation(DefragmentationBudget);
+		//Time count:
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if (!TraceFilename.empty())
+		{
+			VONETrace::Trace_Reader Reader(TraceFilename);
+			Simulate_VONE_on_MCF.run_trace(Reader, WarmupNumber);
+		}
+		else
+		{
+			istringstream Load_List(ErlangLoad);
+			string Load;
+			while (getline(Load_List, Load, ','))
+				Simulate_VONE_on_MCF.run(stod(Load), HoldingTime, ServiceRequestNumber, WarmupNumber);
+		}
+		double running_time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		fout << "The running time of Dynamic is: " << running_time << "ms\n\n";
+		cout << "The running time of Dynamic is: " << running_time << "ms\n\n";
+		fout << Simulate_VONE_on_MCF << "\n";
+		cout << Simulate_VONE_on_MCF << "\n";
 	}
 	else
 	{
@@ -427,8 +544,28 @@ namespace
 			 << "where 'Heuristic' executes the proposed heuristic algorithms to get approximate solutions, \n"
 			 << "where 'ILPHeuristic' implements the ILP method firstly then the heuristic method because the heuristic method may "
 			 << "change the order of service requests. \n"
-			 << "Note that the ILP method may take along time to solve, this argument is suitable for small topology and a few number of service requests. \n";
-		
-		cerr << "\nThe arguments above must be enough and not too much, or the program will be exit with error code -1." << endl;
+			 << "Note that the ILP method may take along time to solve, this argument is suitable for small topology and a few number of service requests. \n"
+			 << "It could also be 'Multistart', 'Anytime', 'Concurrent' or 'Parallel', which solve as 'Heuristic' in the ways below, \n"
+			 << "where 'Multistart' keeps the best of several orderings of the service requests solved on several threads, \n"
+			 << "where 'Anytime' improves the heuristic solution by simulated annealing within a time budget, \n"
+			 << "where 'Concurrent' embeds the service requests on several threads committing them without a lock, \n"
+			 << "where 'Parallel' gets the same solution as 'Heuristic' with the core assignments speculated on several threads. \n"
+			 << "It could also be 'Dynamic', which simulates the service requests arriving and departing, "
+			 << "and reports the blocking probability against the Erlang load. \n";
+
+		cerr << "\nThe arguments above must be enough and not too much, or the program will be exit with error code -1. \n";
+
+		cerr << "\nThe following optional arguments may be appended in any order for the solvers after 'Heuristic': \n"
+			 << "-thread/-n <Number of Threads> for 'Multistart', 'Concurrent' and 'Parallel', 0 for one per hardware thread, which is the default; \n"
+			 << "-start/-m <Number of Orderings> for 'Multistart', 8 by default; \n"
+			 << "-budget/-b <Time Budget> in milliseconds for 'Anytime', 1000 by default; \n"
+			 << "-seed/-d <Random Seed> for 'Multistart', 'Anytime' and 'Dynamic', 1 by default; \n"
+			 << "-kpath/-k <Number of Candidate Paths> of each pair of substrate nodes, 0 for the shortest paths weighted by the Path Distances, which is the default; \n"
+			 << "-erlang/-e <Erlang Loads> for 'Dynamic', such as 100,200,300, each simulated with -rnum/-r service requests; \n"
+			 << "-holding/-o <Mean Holding Time> for 'Dynamic', 1 by default; \n"
+			 << "-warmup/-w <Number of Warm-up Requests> for 'Dynamic', left out of the statistics, 0 by default; \n"
+			 << "-defrag/-g <Time Budget> in milliseconds for 'Dynamic' to defragment the spectrum when a request is blocked, 0 for none, which is the default; \n"
+			 << "-trace/-f <Name of the Trace File> for 'Dynamic' to replay the text or binary trace instead of the Erlang loads. \n"
+			 << "For example: " << ProgramName << " -t 'FITI' -r 10000 -c 7 -h 0 -x 'No' -s 'Dynamic' -e 100,200 -w 1000" << endl;
 	}
 }
\ No newline at end of file